@@ -4,37 +4,61 @@
  * 
  * Handles all serial commands from the Raspberry Pi:
  * 
- * LED Commands:
- *   SHOW <pos> [#id]              - Turn on LED (blue)
+ * LED Commands (<color> = r,g,b | @<palette_index> | H<hue>[,<sat>[,<val>]]):
+ *   SHOW <pos> [color] [ms [DONE]] [#id] - Turn on LED (blue); off again after ms if given
  *   HIDE <pos> [#id]              - Turn off LED
- *   SUCCESS <pos> [#id]           - Play green expansion animation
- *   FAIL <pos> [#id]              - Show red LED (error indicator)
+ *   SUCCESS <pos> [color] [#id]   - Play green expansion animation
+ *   FAIL <pos> [ms [DONE]] [#id]  - Show red LED (error indicator)
  *   CONTRACT <pos> [#id]          - Contract expanded LED back to single
- *   BLINK <pos> [#id]             - Start blinking (orange, fast)
+ *   BLINK <pos> [color] [ms [DONE]] [#id] - Start blinking (green, fast)
  *   STOP_BLINK <pos> [#id]        - Stop blinking
  *   EXPAND_STEP <pos> [#id]       - Expand lit area by 1 LED on each side
  *   CONTRACT_STEP <pos> [#id]     - Contract lit area by 1 LED on each side
- *   MENUE_CHANGE <r,g,b> <range>  - Expand animation on both strips from 0 to range
+ *   EXPAND_TO <pos> <radius> [ms] [#id] - Set lit area to a radius, animated over ms if given
+ *   METER <from> <to> <level> [color] [#id] - Level bar (0-255) across the LEDs from one position to another
+ *   MENUE_CHANGE <color> <range>  - Expand animation on both strips from 0 to range
+ *   HUE_CYCLE <pos> [period_ms]   - Rotate through the color wheel until HIDE/SHOW
+ *   PALETTE <i> <color> [#id]     - Set palette entry i (0-15)
  *   SEQUENCE_COMPLETED [#id]      - Play celebration animation
+ *   PATTERN <n> [#id]             - Play built-in whole-board pattern n (LedPatterns.h)
+ *   FRAME_SYNC <every_n> [#id]    - Emit FRAME <n> t=<ms> every n-th LED frame (0 = off)
+ *   GET_FRAME [strip] [from] [count] [#id] - Stream the logical framebuffer as PIXELS lines
+ *   FRAME_HASH [strip] [#id]      - FNV-1a hash of the logical framebuffer per strip
+ *   SCENE_STORE <slot> [#id]      - Save all positions, meters and expectations (slot 0-7)
+ *   SCENE_RECALL <slot> [#id]     - Restore a saved scene in one frame
+ *   SEQ_PLAY <positions> <on_ms> <gap_ms> [#id] - Light positions in turn (e.g. ACEB)
  * 
  * Touch Commands:
- *   EXPECT <pos> [#id]            - Wait for touch
- *   EXPECT_RELEASE <pos> [#id]    - Wait for release
+ *   EXPECT <pos> [profile] [LEVEL] [#id] - Wait for touch (profile: FAST|NORMAL|STRICT)
+ *   EXPECT_RELEASE <pos> [profile] [LEVEL] [#id] - Wait for release
+ *                                 (LEVEL: report at once if already in that state)
  *   RECALIBRATE <pos> [#id]       - Recalibrate single sensor
  *   RECALIBRATE_ALL [#id]         - Recalibrate all sensors
  *   VALUE <pos> [#id]             - Get current sensor delta value
  *   SET_SENSITIVITY <pos> <lvl>   - Set sensitivity (0=most, 7=least)
+ *   SEQ_VERIFY <positions> <timeout_ms> [#id] - Score touches in order, results in DONE
+ *   REACT <pos> [timeout_ms] [#id] - Light pos, report us from the frame shown to the press
+ *   INJECT <pos> DOWN|UP [delay_ms] [#id]                  - Inject a synthetic touch edge
+ *   INJECT_RUN <SEQ|RANDOM|ALL> <rate_hz> <count> [hold_ms] - Scripted injection
+ *   INJECT_STOP [#id]             - Stop a running injection script
+ *   STATS [#id]                   - Touch edge counters (real/synthetic/suppressed)
  * 
  * Utility Commands:
  *   PING [#id]                    - Health check
  *   INFO [#id]                    - Get firmware info
  *   SCAN [#id]                    - Scan for connected sensors
+ *   SELFTEST [#id]                - Measure noise floor and response times per sensor
+ *   DISCOVER [#id]                - Re-scan the bus, list unassigned CAP1188 chips
+ *   ASSIGN <addr> <pos> [#id]     - Map I2C address (hex, 0 = clear) to a position
+ *   ASSIGN_TOUCH <pos> [#id]      - Map the next touched unassigned chip to a position
  */
 
 #ifndef COMMAND_CONTROLLER_H
 #define COMMAND_CONTROLLER_H
 
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 #include "Config.h"
 
 class LedController;
@@ -67,13 +91,36 @@ enum class CommandAction : uint8_t {
     SCAN,
     SEQUENCE_COMPLETED,
     INFO,
-    PING
+    PING,
+    SELFTEST,
+    DISCOVER,
+    ASSIGN,
+    ASSIGN_TOUCH,
+    INJECT,
+    INJECT_RUN,
+    INJECT_STOP,
+    STATS,
+    PALETTE,
+    HUE_CYCLE,
+    PATTERN,
+    FRAME_SYNC,
+    GET_FRAME,
+    FRAME_HASH,
+    EXPAND_TO,
+    METER,
+    SCENE_STORE,
+    SCENE_RECALL,
+    SEQ_PLAY,
+    SEQ_VERIFY,
+    REACT
 };
 
 // ============================================================================
 // Parsed Command Structure
 // ============================================================================
 
+constexpr uint8_t PALETTE_INDEX_NONE = 255;
+
 struct ParsedCommand {
     CommandAction action;
     bool hasPosition;
@@ -81,21 +128,36 @@ struct ParsedCommand {
     uint8_t positionIndex;
     bool hasId;
     uint32_t id;
-    uint8_t extraValue;  // For commands that need an extra numeric parameter (e.g., sensitivity level)
-    uint8_t r, g, b;     // RGB color for MENUE_CHANGE
+    uint8_t extraValue;  // Extra parameter (sensitivity level, debounce profile, I2C address, METER end)
+    bool level;          // EXPECT / EXPECT_RELEASE: level-triggered (LEVEL)
+    bool reportDone;     // Timed SHOW / FAIL / BLINK: send DONE when the state ends (DONE)
+    bool hasColor;
+    uint8_t r, g, b;     // RGB color (MENUE_CHANGE, PALETTE, optional LED color)
+    uint8_t paletteIndex; // @<i> color, looked up at execution (PALETTE_INDEX_NONE = r,g,b as given)
     uint8_t range;       // Range for MENUE_CHANGE
+    uint16_t args[4];    // Trailing numeric arguments (delays, rates, counts)
+    uint8_t argCount;
+    uint8_t steps[SEQ_MAX_STEPS];  // Position indexes (SEQ_PLAY, SEQ_VERIFY)
+    uint8_t stepCount;
     bool valid;
+    const char* error;   // Parse error reason when !valid (nullptr = nothing to report)
 };
 
 // ============================================================================
 // Queued Command (for long-running commands)
 // ============================================================================
 
+constexpr uint8_t QUEUED_STATE_RUNNING = 0;
+constexpr uint8_t QUEUED_STATE_FRAME_WAIT = 1;  // LED part done, waiting for doneFrame to be shown
+
 struct QueuedCommand {
     ParsedCommand command;
     bool active;
     uint32_t startTime;
     uint8_t state;
+    uint32_t doneFrame;   // Frame that shows the end state (QUEUED_STATE_FRAME_WAIT)
+    uint8_t step;         // Progress through steps (SEQ_PLAY, SEQ_VERIFY, REACT)
+    uint32_t stepTime;    // SEQ_VERIFY: press that ended the previous step, REACT: LED shown
 };
 
 // ============================================================================
@@ -112,7 +174,16 @@ public:
     void pollSerial();
     void processCompletedLines();
     void tick();
+    
+    // Split pipeline: the serial task parses, the main loop executes
+    void parseCompletedLines();
+    void executeParsedCommands();
     bool isQueueFull() const;
+    bool hasActiveCommands() const;
+    
+    // Overload governor inputs and controls
+    uint8_t getRxFillPercent() const;
+    void setRejectNew(bool enabled);
 
 private:
     LedController& m_ledController;
@@ -130,22 +201,80 @@ private:
     uint8_t m_lineIndex;
     bool m_lineOverflow;
     
+    // Parsed commands from the serial task, in arrival order
+    QueueHandle_t m_parsedQueue;
+    volatile bool m_rejectNew;  // Overload: answer new commands with BUSY
+    
+    // Sensor request on the touch task; later sensor commands wait for its reply
+    bool m_sensorRequestPending;
+    uint32_t m_sensorRequestTime;
+    uint32_t m_sensorRequestId;
+    ParsedCommand m_heldCommands[TOUCH_REQUEST_QUEUE_SIZE];  // Sensor commands waiting for that reply
+    uint8_t m_heldHead;
+    uint8_t m_heldCount;
+    
     // Command queue
     QueuedCommand m_commandQueue[QUEUE_SIZE_COMMANDS];
     
+    // FRAME event stream (FRAME_SYNC)
+    uint16_t m_frameSyncEvery;
+    uint32_t m_lastSyncedFrame;
+    
+    // Framebuffer readback (GET_FRAME), streamed from a snapshot taken at start
+    uint8_t m_frameSnapshot[(LED_STRIP_1_LENGTH + LED_STRIP_2_LENGTH) * 3];
+    bool m_readbackActive;
+    uint8_t m_readbackStrip;
+    uint8_t m_readbackLastStrip;
+    uint16_t m_readbackNext;
+    uint16_t m_readbackEnd;
+    uint16_t m_readbackLastEnd;
+    
+    // SEQ_VERIFY reads the touch task's press stream; one run at a time
+    bool m_seqVerifyActive;
+    uint16_t m_seqVerifyMs[SEQ_MAX_STEPS];  // Reaction time per step reached, sent with DONE
+    char m_seqVerifyMiss;                   // Failed step: touched position, '-' = timeout, 0 = none
+    bool m_reactActive;  // REACT uses the single reaction probe
+    
     // Parsing methods
     bool extractLine();
     bool parseLine(const char* line, ParsedCommand& cmd);
     static CommandAction parseAction(const char* str, size_t len);
+    static bool parseDebounceProfile(const char* str, size_t len, uint8_t& profile);
+    static bool parseInjectPattern(const char* str, size_t len, uint8_t& pattern);
+    static bool parseNumericArgs(const char*& p, ParsedCommand& cmd);
+    static bool isColorToken(const char* str, size_t len);
+    static int8_t parseByteList(const char* str, size_t len, uint8_t* values, uint8_t maxValues);
+    static bool parseColor(const char* str, size_t len, ParsedCommand& cmd);
     static const char* actionToString(CommandAction action);
     static bool actionRequiresPosition(CommandAction action);
     static bool actionIsLongRunning(CommandAction action);
+    static bool isLongRunning(const ParsedCommand& cmd);
+    static bool isTimedState(const ParsedCommand& cmd);
     
     // Execution methods
     void executeCommand(const ParsedCommand& cmd);
     void executeInstant(const ParsedCommand& cmd);
+    void dispatchCommand(const ParsedCommand& cmd);
+    bool resumeHeldCommands();
+    static bool waitsForSensorRequest(CommandAction action);
+    void awaitSensorRequest(bool submitted, uint32_t cmdId);
+    void pollSensorReply();
     bool queueCommand(const ParsedCommand& cmd);
     void tickCommand(QueuedCommand& qc);
+    void finishLedCommand(QueuedCommand& qc);
+    void tickLedDone(QueuedCommand& qc);
+    void queueLedDone(const QueuedCommand& qc, char position);
+    void tickFrameSync();
+    bool startReadback(const ParsedCommand& cmd);
+    bool tickReadback(uint32_t cmdId);
+    bool tickSeqPlay(QueuedCommand& qc);
+    bool tickSeqVerify(QueuedCommand& qc);
+    void reportSeqVerify(const QueuedCommand& qc, uint32_t cmdId);
+    bool tickReact(QueuedCommand& qc, uint32_t cmdId);
+    void releaseTimedStates(const ParsedCommand& cmd);
+    bool drawsOver(const ParsedCommand& cmd, uint8_t positionIndex) const;
+    void endTimedState(QueuedCommand& qc);
+    void reportSelfTest(uint32_t cmdId);
     
     // Utilities
     static const char* skipWhitespace(const char* str);
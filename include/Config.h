@@ -16,6 +16,8 @@
  *   8. Colors
  *   9. I2C Configuration
  *   10. Sensor Addresses
+ *   10b. Sensor Adjacency
+ *   11. Protocol Constants
  */
 
 #ifndef CONFIG_H
@@ -54,15 +56,19 @@ constexpr uint8_t PIN_I2C_SCL = 22;  // Default ESP32 SCL
 
 // Core assignments
 constexpr uint8_t CORE_TOUCH_SENSOR = 0;  // Core 0: I2C touch polling
-constexpr uint8_t CORE_MAIN_LOOP    = 1;  // Core 1: Serial, LED, commands
+constexpr uint8_t CORE_MAIN_LOOP    = 1;  // Core 1: LED, command execution
+constexpr uint8_t CORE_SERIAL_RX    = 1;  // Core 1: serial line parsing (preempts the loop)
+constexpr uint8_t CORE_LED_OUTPUT   = 0;  // Core 0: clocks composed frames out to the strips
 
 // Task stack sizes (bytes)
-constexpr uint32_t STACK_SIZE_TOUCH_TASK = 4096;
-constexpr uint32_t STACK_SIZE_LED_TASK   = 4096;
+constexpr uint32_t STACK_SIZE_TOUCH_TASK  = 4096;
+constexpr uint32_t STACK_SIZE_LED_TASK    = 4096;
+constexpr uint32_t STACK_SIZE_SERIAL_TASK = 4096;
 
 // Task priorities (higher = more important)
-constexpr uint8_t PRIORITY_TOUCH_TASK = 2;
-constexpr uint8_t PRIORITY_LED_TASK   = 1;
+constexpr uint8_t PRIORITY_TOUCH_TASK  = 2;
+constexpr uint8_t PRIORITY_LED_TASK    = 1;  // Below touch polling on the same core
+constexpr uint8_t PRIORITY_SERIAL_TASK = 3;
 
 // ============================================================================
 // 4. SERIAL COMMUNICATION
@@ -74,6 +80,7 @@ constexpr size_t SERIAL_TX_BUFFER_SIZE = 256;
 constexpr size_t SERIAL_LINE_MAX_LENGTH = 64;
 constexpr uint16_t SERIAL_STARTUP_WAIT_MS = 3000;  // Max wait for serial ready
 constexpr uint16_t SERIAL_LINE_TIMEOUT_MS = 50;    // Timeout to complete partial line
+constexpr uint8_t SERIAL_PARSED_QUEUE_SIZE = 16;   // Serial task -> main loop parsed commands
 
 // ============================================================================
 // 5. QUEUES & BUFFERS
@@ -89,6 +96,29 @@ constexpr uint8_t EVENTS_PER_FLUSH = 5;  // Max events to send per loop iteratio
 // Serial output buffer
 constexpr size_t EVENT_MESSAGE_BUFFER_SIZE = 96;  // Max chars per event message
 
+// Framebuffer readback (GET_FRAME): PIXELS lines queued per loop pass, and
+// the event queue fill level above which streaming pauses so touch events
+// still find room
+constexpr uint8_t GET_FRAME_CHUNKS_PER_TICK = 4;
+constexpr uint8_t GET_FRAME_QUEUE_HEADROOM = 16;
+
+// Overload governor: sheds load in steps instead of dropping events or input.
+// Pressure is the highest of event queue fill, RX backlog fill and loop time
+// (relative to LOAD_LOOP_BUDGET_US), in percent. Each level has an entry
+// threshold; a level is left once pressure has stayed LOAD_HYSTERESIS_PCT
+// below it for LOAD_RELEASE_MS.
+constexpr bool LOAD_GOVERNOR_ENABLED = true;
+constexpr uint16_t LOAD_EVAL_INTERVAL_MS = 20;
+constexpr uint32_t LOAD_LOOP_BUDGET_US = 10000;
+constexpr uint8_t LOAD_THRESHOLD_FRAME_RATE_PCT = 50;  // Cap the LED frame rate
+constexpr uint8_t LOAD_THRESHOLD_SKIP_STEPS_PCT = 65;  // Skip intermediate animation steps
+constexpr uint8_t LOAD_THRESHOLD_COALESCE_PCT   = 80;  // Merge ACKs of commands without #id
+constexpr uint8_t LOAD_THRESHOLD_REJECT_PCT     = 90;  // Answer new commands with BUSY
+constexpr uint8_t LOAD_HYSTERESIS_PCT = 10;
+constexpr uint16_t LOAD_RELEASE_MS = 500;
+constexpr uint16_t LOAD_REDUCED_FRAME_MS = 33;         // Min time between frames when capped
+constexpr uint8_t LOAD_MAX_CATCHUP_STEPS = 4;          // Animation steps per frame when skipping
+
 // Sensor list buffer (for SCANNED response)
 constexpr size_t SENSOR_LIST_BUFFER_SIZE = 64;
 
@@ -105,13 +135,57 @@ constexpr uint16_t MUTEX_TIMEOUT_FLUSH_MS  = 5;
 // ============================================================================
 
 constexpr uint8_t TOUCH_SENSOR_COUNT = 25;  // Total sensors (A-Y)
-constexpr uint8_t EXPECTED_SENSOR_COUNT = 4; // Number of sensors expected to be found on startup
 constexpr uint16_t TOUCH_POLL_INTERVAL_MS = 5;
 constexpr uint16_t TOUCH_DEBOUNCE_PRESS_MS = 100;
 constexpr uint16_t TOUCH_DEBOUNCE_RELEASE_MS = 100;
+
+// Debounce profiles selectable per expectation (EXPECT A FAST).
+// NORMAL uses TOUCH_DEBOUNCE_PRESS_MS / TOUCH_DEBOUNCE_RELEASE_MS.
+constexpr uint16_t TOUCH_DEBOUNCE_FAST_PRESS_MS = 15;
+constexpr uint16_t TOUCH_DEBOUNCE_FAST_RELEASE_MS = 30;
+constexpr uint16_t TOUCH_DEBOUNCE_STRICT_PRESS_MS = 200;
+constexpr uint16_t TOUCH_DEBOUNCE_STRICT_RELEASE_MS = 250;
 constexpr uint16_t TOUCH_INIT_DELAY_MS = 500;
 constexpr uint16_t TOUCH_RECAL_DELAY_MS = 1500;
 
+// Press metrics: sample the delta register while a sensor is touched and
+// append peak=<delta> / ms=<duration> to TOUCHED and TOUCH_RELEASED events.
+// Costs one extra I2C read per touched sensor per sweep.
+constexpr bool TOUCH_REPORT_METRICS = true;
+
+// SELFTEST: idle delta samples per sensor and max wait for recalibration.
+// A sensor fails on any I2C error, a recalibration timeout, idle noise
+// (delta variance) above SELFTEST_MAX_VARIANCE or an average I2C
+// transaction slower than SELFTEST_MAX_I2C_US.
+constexpr uint16_t SELFTEST_SAMPLE_COUNT = 64;
+constexpr uint16_t SELFTEST_RECAL_TIMEOUT_MS = 2000;
+constexpr float SELFTEST_MAX_VARIANCE = 4.0f;
+constexpr uint16_t SELFTEST_MAX_I2C_US = 500;
+
+// VALUE / RECALIBRATE / SET_SENSITIVITY requests waiting for the touch task,
+// and how long one may wait to be started before it is cancelled (ERR sensor_timeout)
+constexpr uint8_t TOUCH_REQUEST_QUEUE_SIZE = 8;
+constexpr uint16_t TOUCH_REQUEST_TIMEOUT_MS = 250;
+
+// Debounced presses handed to the main loop while SEQ_VERIFY listens
+constexpr uint8_t TOUCH_EDGE_QUEUE_SIZE = 8;
+
+// REACT <pos> [timeout_ms]: how long to wait for the press by default
+constexpr uint16_t REACT_DEFAULT_TIMEOUT_MS = 5000;
+
+// Synthetic touch injection (INJECT / INJECT_RUN)
+constexpr uint8_t INJECT_QUEUE_SIZE = 16;    // Core 1 -> touch task hand-off
+constexpr uint8_t INJECT_PENDING_SIZE = 64;  // Scheduled edges waiting for their due time
+constexpr uint16_t INJECT_DEFAULT_HOLD_MS = 150;
+constexpr uint16_t INJECT_MAX_RATE_HZ = 200;
+
+// Sensor power policy: with no expectations armed and no touch for the given
+// time, sensors drop to CAP1188 standby (touch still wakes) and optionally to
+// deep sleep (only a new expectation wakes). 0 disables the stage.
+constexpr uint32_t TOUCH_STANDBY_AFTER_MS = 30000;
+constexpr uint32_t TOUCH_DEEP_SLEEP_AFTER_MS = 0;
+constexpr uint16_t TOUCH_STANDBY_POLL_INTERVAL_MS = 50;  // Sweep interval while in standby
+
 // ============================================================================
 // 7. LED CONTROL
 // ============================================================================
@@ -129,6 +203,16 @@ constexpr uint8_t LED_POSITION_COUNT = 25;  // Logical positions (A-Y)
 
 constexpr uint8_t LED_BRIGHTNESS_DEFAULT = 128;  // 0-255
 
+// Logical framebuffer format. Indexed keeps one byte per pixel pointing into a
+// small table of the colors currently on the strips (about half the RAM of RGB
+// with 380 pixels); pixels are expanded to the strips' GRB only when a frame is
+// handed over. With more distinct colors than table entries, new colors snap
+// to the nearest, so gradients and patterns lose shades in this mode.
+constexpr bool LED_INDEXED_FRAMEBUFFER = false;
+constexpr uint8_t LED_COLOR_TABLE_SIZE = 32;   // Entries incl. black at 0 (16-64)
+constexpr uint8_t LED_COLOR_HASH_SIZE = LED_COLOR_TABLE_SIZE * 2;  // Lookup slots, kept at most half full
+constexpr uint8_t LED_FRAME_PIXEL_BYTES = LED_INDEXED_FRAMEBUFFER ? 1 : 3;
+
 // Animation timing (milliseconds)
 constexpr uint16_t LED_ANIMATION_STEP_MS = 25;
 constexpr uint16_t LED_BLINK_INTERVAL_MS = 150;
@@ -170,6 +254,51 @@ constexpr uint8_t COLOR_OFF_R = 0;
 constexpr uint8_t COLOR_OFF_G = 0;
 constexpr uint8_t COLOR_OFF_B = 0;
 
+// Device palette (PALETTE <i> <color>, referenced as @<i> in LED commands)
+constexpr uint8_t LED_PALETTE_SIZE = 16;
+
+constexpr uint8_t LED_PALETTE_DEFAULTS[LED_PALETTE_SIZE][3] = {
+    {   0,   0,   0 },  //  0 off
+    {   0,   0, 255 },  //  1 blue (SHOW)
+    {   0, 255,   0 },  //  2 green (SUCCESS, BLINK)
+    { 255,   0,   0 },  //  3 red (FAIL)
+    { 255, 255, 255 },  //  4 white
+    { 255, 255,   0 },  //  5 yellow
+    { 255, 128,   0 },  //  6 orange
+    {   0, 255, 255 },  //  7 cyan
+    { 255,   0, 255 },  //  8 magenta
+    { 128,   0, 255 },  //  9 purple
+    { 255,  64, 128 },  // 10 pink
+    { 128, 255,   0 },  // 11 lime
+    {   0, 128, 255 },  // 12 sky
+    { 255, 192, 128 },  // 13 warm white
+    {  64,  64,  64 },  // 14 dim white
+    {   0,  64,   0 }   // 15 dim green
+};
+
+// Hue rotation (HUE_CYCLE): default time for one full turn of the color wheel
+constexpr uint16_t LED_HUE_CYCLE_DEFAULT_MS = 3000;
+
+// Range meters (METER <from> <to> <level>): how many spans can be driven at once
+constexpr uint8_t LED_METER_SLOTS = 4;
+
+// SCENE_STORE / SCENE_RECALL: board layouts kept in RAM (lost on reset)
+constexpr uint8_t SCENE_SLOTS = 8;
+
+// SEQ_PLAY / SEQ_VERIFY: longest position sequence in one command
+constexpr uint8_t SEQ_MAX_STEPS = 16;
+
+// SEQ_VERIFY: reaction times per SEQ_TIMES line when they overflow the DONE line
+constexpr uint8_t SEQ_TIMES_CHUNK_LENGTH = 40;
+
+// Frame sync: append frame=<n> t=<ms> (the strip output that finished the
+// animation) to DONE of LED animations, for aligning sound with visuals.
+constexpr bool LED_REPORT_DONE_FRAME = true;
+
+// Show times of the last frames, looked up by frame number (DONE, FRAME, REACT).
+// The main loop sees at most a couple of new frames per pass.
+constexpr uint8_t LED_FRAME_TIME_HISTORY = 8;
+
 // ============================================================================
 // 9. I2C CONFIGURATION
 // ============================================================================
@@ -178,6 +307,34 @@ constexpr uint32_t I2C_CLOCK_SPEED_HZ = 400000;  // 400kHz Fast Mode
 constexpr uint8_t I2C_RETRY_COUNT = 3;
 constexpr uint16_t I2C_RETRY_DELAY_US = 100;
 
+// Bus discovery range (7-bit addresses, reserved ranges excluded)
+constexpr uint8_t I2C_DISCOVERY_FIRST_ADDRESS = 0x08;
+constexpr uint8_t I2C_DISCOVERY_LAST_ADDRESS = 0x77;
+
+// Bus recovery: a sweep in which no active sensor answers is a bus-wide
+// failure (typically a chip holding SDA low after a brownout). After
+// I2C_BUS_FAIL_SWEEPS of them in a row, SCL is clocked until SDA is released,
+// a STOP is sent, Wire is restarted and the sensors are reconfigured.
+// With no active sensor, a low SDA or SCL counts as a failed sweep, and
+// recovery runs discovery again (bus stuck since boot).
+// Retried every I2C_RECOVERY_RETRY_MS while the bus stays down.
+constexpr uint8_t I2C_BUS_FAIL_SWEEPS = 3;
+constexpr uint16_t I2C_RECOVERY_RETRY_MS = 100;
+constexpr uint8_t I2C_RECOVERY_CLOCK_PULSES = 9;   // Enough to finish any byte in flight
+constexpr uint8_t I2C_RECOVERY_HALF_PERIOD_US = 5;  // ~100kHz bit-banged clock
+
+// Touch-to-assign gives up if no unassigned chip is touched in time.
+// Unassigned chips are read every TOUCH_ASSIGN_POLL_INTERVAL_MS for a new press.
+constexpr uint32_t TOUCH_ASSIGN_TIMEOUT_MS = 30000;
+constexpr uint16_t TOUCH_ASSIGN_POLL_INTERVAL_MS = 20;
+
+// DISCOVERED: unassigned address list per line; longer lists continue on the next
+constexpr uint8_t DISCOVERED_LIST_CHUNK_LENGTH = 40;
+
+// NVS storage for the address map
+#define TOUCH_MAP_NVS_NAMESPACE "touchmap"
+#define TOUCH_MAP_NVS_KEY "addr"
+
 // ============================================================================
 // CAP1188 TOUCH SENSOR REGISTERS
 // ============================================================================
@@ -194,6 +351,7 @@ constexpr uint8_t CAP1188_REG_INTERRUPT_ENABLE = 0x27;
 constexpr uint8_t CAP1188_REG_REPEAT_ENABLE = 0x28;
 constexpr uint8_t CAP1188_REG_MULTIPLE_TOUCH_CONFIG = 0x2A;
 constexpr uint8_t CAP1188_REG_SENSOR_THRESHOLD_1 = 0x30;
+constexpr uint8_t CAP1188_REG_STANDBY_CHANNEL = 0x40;
 constexpr uint8_t CAP1188_REG_STANDBY_CONFIG = 0x41;
 constexpr uint8_t CAP1188_REG_LED_LINK = 0x72;
 constexpr uint8_t CAP1188_REG_PRODUCT_ID = 0xFD;
@@ -201,14 +359,26 @@ constexpr uint8_t CAP1188_REG_MANUFACTURER_ID = 0xFE;
 constexpr uint8_t CAP1188_REG_REVISION = 0xFF;
 
 // CAP1188 default values
+constexpr uint8_t CAP1188_PRODUCT_ID = 0x50;
 constexpr uint8_t CAP1188_CS1_BIT_MASK = 0x01;
 constexpr uint8_t CAP1188_DEFAULT_SENSITIVITY = 0;
 constexpr uint8_t CAP1188_DEFAULT_THRESHOLD = 0x10;
 constexpr uint8_t CAP1188_DEFAULT_AVERAGING = 0x25;
 
+// MAIN_CONTROL power bits
+constexpr uint8_t CAP1188_MAIN_STBY_BIT = 0x20;
+constexpr uint8_t CAP1188_MAIN_DSLEEP_BIT = 0x10;
+
+// STANDBY_CONFIG: 8 samples / 35ms cycle while active, 2 samples / 200ms cycle in standby
+constexpr uint8_t CAP1188_STANDBY_CONFIG_FAST = 0x30;
+constexpr uint8_t CAP1188_STANDBY_CONFIG_LOW_POWER = 0x13;
+
 // ============================================================================
 // 10. SENSOR I2C ADDRESSES (A-Y mapping)
 // ============================================================================
+// Default map, used until positions are assigned with ASSIGN / ASSIGN_TOUCH.
+// Assigned maps are persisted in NVS and take precedence on boot.
+// ============================================================================
 
 constexpr uint8_t SENSOR_I2C_ADDRESSES[TOUCH_SENSOR_COUNT] = {
     0x1F, 0x1E, 0x1D, 0x1C, 0x3F,  // A-E (FOR DEVBOARD)
@@ -218,6 +388,21 @@ constexpr uint8_t SENSOR_I2C_ADDRESSES[TOUCH_SENSOR_COUNT] = {
     0x2C, 0x3D, 0x08, 0x09, 0x0A   // U-Y
 };
 
+// ============================================================================
+// 10b. SENSOR ADJACENCY (cross-talk suppression)
+// ============================================================================
+// Pairs of physically neighboring positions. When neighbors start a press
+// within TOUCH_CROSSTALK_WINDOW_MS of each other, only the one with the
+// larger delta is accepted; the other is held off until it is released.
+// ============================================================================
+
+constexpr bool TOUCH_CROSSTALK_SUPPRESSION = true;
+constexpr uint16_t TOUCH_CROSSTALK_WINDOW_MS = 20;
+
+constexpr char SENSOR_ADJACENT_PAIRS[][2] = {
+    { 'A', 'B' }, { 'B', 'C' }, { 'C', 'D' }, { 'D', 'E' }  // (FOR DEVBOARD)
+};
+
 // ============================================================================
 // 11. PROTOCOL CONSTANTS
 // ============================================================================
@@ -28,7 +28,19 @@ enum class EventType : uint8_t {
     SCANNED,        // Sensor scan complete
     RECALIBRATED,   // Sensor recalibrated
     INFO,           // Firmware info
-    VALUE           // Sensor value response
+    VALUE,          // Sensor value response
+    POWER,          // Sensor power mode changed
+    ASSIGNED,       // Address mapped to a position
+    DISCOVERED,     // Bus discovery complete
+    SELFTEST,       // Packed per-sensor self-test reports
+    STATS,          // Touch edge counters
+    FRAME,          // LED frame sync (FRAME_SYNC)
+    PIXELS,         // Framebuffer readback chunk (GET_FRAME)
+    FRAME_HASH,     // Framebuffer hash
+    LOAD,           // Overload governor level changed
+    BUS_RECOVERED,  // I2C bus recovered after an outage
+    SEQ_TIMES,      // SEQ_VERIFY reaction times too long for its DONE line
+    REACT           // Reaction time from LED shown to press
 };
 
 // ============================================================================
@@ -59,29 +71,53 @@ public:
     bool isFull() const;
     bool isEmpty() const;
     uint8_t count() const;
+    uint8_t readbackCount() const;  // Queued PIXELS chunks (planned GET_FRAME burst)
+    
+    // Merge ACKs without #id into the newest queued identical ACK (overload governor)
+    void setCoalesceAcks(bool enabled);
     
     // Queue event methods (thread-safe, callable from any core)
     bool queueAck(const char* action, char position = 0, uint32_t commandId = COMMAND_ID_NONE);
     bool queueDone(const char* action, char position = 0, uint32_t commandId = COMMAND_ID_NONE);
+    bool queueDone(const char* action, char position, uint32_t commandId, uint32_t frame, uint32_t frameTimeMs);
+    bool queueDone(const char* action, char position, uint32_t commandId, const char* detail);
     bool queueError(const char* reason, uint32_t commandId = COMMAND_ID_NONE);
     bool queueBusy(uint32_t commandId = COMMAND_ID_NONE);
     bool queueTouched(char position, uint32_t commandId = COMMAND_ID_NONE);
     bool queueTouchReleased(char position, uint32_t commandId = COMMAND_ID_NONE);
+    bool queueTouched(char position, uint32_t commandId, int8_t peakDelta);
+    bool queueTouchReleased(char position, uint32_t commandId, int8_t peakDelta, uint32_t durationMs);
     bool queueScanned(const char* sensorList, uint32_t commandId = COMMAND_ID_NONE);
     bool queueRecalibrated(char position, uint32_t commandId = COMMAND_ID_NONE);
     bool queueInfo(uint32_t commandId = COMMAND_ID_NONE);
     bool queueValue(char position, int8_t value, uint32_t commandId = COMMAND_ID_NONE);
+    bool queuePower(const char* mode, uint32_t wakeLatencyUs = 0);
+    bool queueAssigned(char position, uint8_t address, uint32_t commandId = COMMAND_ID_NONE);
+    bool queueDiscovered(uint8_t count, const char* unassignedList, bool more,
+                         uint32_t commandId = COMMAND_ID_NONE);
+    bool queueStats(const char* report, uint32_t commandId = COMMAND_ID_NONE);
+    bool queueFrame(uint32_t frame, uint32_t frameTimeMs);
+    bool queuePixels(uint8_t strip, uint16_t from, const char* runs, uint32_t commandId = COMMAND_ID_NONE);
+    bool queueFrameHash(uint8_t strip, uint32_t hash, uint32_t frame, uint32_t commandId = COMMAND_ID_NONE);
+    bool queueLoad(uint8_t level, const char* name, uint8_t eventFill, uint8_t rxFill, uint32_t loopUs);
+    bool queueBusRecovered(uint32_t outageMs, uint8_t sensorCount);
+    bool queueSelfTest(const char* reports, uint32_t commandId = COMMAND_ID_NONE);
+    bool queueSeqTimes(uint8_t fromStep, const char* times, uint32_t commandId = COMMAND_ID_NONE);
+    bool queueReact(char position, uint32_t reactionUs, uint32_t commandId = COMMAND_ID_NONE);
 
 private:
     Event m_events[QUEUE_SIZE_EVENTS];
     uint8_t m_head;
     uint8_t m_tail;
     volatile uint8_t m_count;
+    volatile uint8_t m_readbackCount;
+    volatile bool m_coalesceAcks;
     
     SemaphoreHandle_t m_queueMutex;
     SemaphoreHandle_t m_serialMutex;
     
     bool enqueue(const Event& event);
+    bool coalesceAck(const char* action, char position);
     void sendEvent(const Event& event);
 };
 
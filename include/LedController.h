@@ -3,7 +3,18 @@
  * @brief LED Controller for dual addressable LED strips
  * 
  * Manages 25 logical LED positions (A-Y) mapped to two physical LED strips.
- * Supports SHOW, HIDE, SUCCESS, BLINK, STOP_BLINK, and SEQUENCE_COMPLETED.
+ * Supports SHOW, HIDE, SUCCESS, BLINK, STOP_BLINK, SEQUENCE_COMPLETED and
+ * whole-board patterns from the built-in library (LedPatterns.h).
+ * Colors can be given per command (RGB, HSV or a 16-entry device palette).
+ * METER drives a level bar across the pixels between two positions.
+ * The settled state of every position and meter can be captured as a
+ * scene and restored in a single frame (SCENE_STORE / SCENE_RECALL).
+ * 
+ * Rendering is a two-stage pipeline. tick() composes frames into the
+ * logical framebuffer; a finished frame is copied into the strip buffers
+ * and clocked out by outputTick() in the LED output task (other core),
+ * while tick() already composes the next one. Without an output task
+ * (setOutputTask not called) tick() shows frames itself.
  */
 
 #ifndef LED_CONTROLLER_H
@@ -11,7 +22,10 @@
 
 #include <Arduino.h>
 #include <Adafruit_NeoPixel.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include "Config.h"
+#include "LedPatterns.h"
 
 // ============================================================================
 // Types
@@ -24,13 +38,24 @@ struct LedMapping {
     uint8_t index;
 };
 
+struct RgbColor {
+    uint8_t r, g, b;
+};
+
+constexpr RgbColor RGB_SHOW    = { COLOR_SHOW_R, COLOR_SHOW_G, COLOR_SHOW_B };
+constexpr RgbColor RGB_SUCCESS = { COLOR_SUCCESS_R, COLOR_SUCCESS_G, COLOR_SUCCESS_B };
+constexpr RgbColor RGB_BLINK   = { COLOR_BLINK_R, COLOR_BLINK_G, COLOR_BLINK_B };
+constexpr RgbColor RGB_FAIL    = { COLOR_FAIL_R, COLOR_FAIL_G, COLOR_FAIL_B };
+
 enum class PositionState : uint8_t {
     OFF,
     SHOWN,
     ANIMATING,
     EXPANDED,
     CONTRACTING,
-    BLINKING
+    BLINKING,
+    HUE_CYCLING,
+    EXPANDING       // Animating expansionRadius toward targetRadius (EXPAND_TO)
 };
 
 struct PositionData {
@@ -39,6 +64,38 @@ struct PositionData {
     uint32_t lastAnimationTime;
     bool blinkOn;
     uint8_t expansionRadius;  // Current expansion radius for EXPAND_STEP/CONTRACT_STEP
+    RgbColor color;           // Color of the current state (SHOW/SUCCESS/BLINK/FAIL)
+    uint16_t hueCycleMs;      // Period of one hue turn while HUE_CYCLING
+    uint32_t hueCycleStart;
+    uint8_t targetRadius;     // EXPAND_TO target while EXPANDING
+    uint16_t expandStepMs;    // Time per radius step while EXPANDING
+};
+
+struct MeterData {
+    bool active;
+    uint8_t from;             // Position at the empty end (level 0)
+    uint8_t to;               // Position at the full end (level 255)
+    uint16_t fill;            // Lit length in 1/256 LED units
+    RgbColor color;
+};
+
+struct ScenePosition {
+    PositionState state;      // Settled: OFF, SHOWN, EXPANDED, BLINKING or HUE_CYCLING
+    RgbColor color;
+    uint8_t radius;           // Lit radius while SHOWN
+    uint16_t hueCycleMs;
+};
+
+struct FrameTime {
+    uint32_t frame;           // Frame number this entry belongs to
+    uint32_t shownMillis;     // When its show() returned
+    uint32_t shownMicros;
+};
+
+struct LedScene {
+    bool stored;
+    ScenePosition positions[LED_POSITION_COUNT];
+    MeterData meters[LED_METER_SLOTS];
 };
 
 // ============================================================================
@@ -52,17 +109,33 @@ public:
     void begin();
     void tick();
     
+    // Output stage (LED output task)
+    void setOutputTask(TaskHandle_t task);
+    void outputTick();
+    
     // LED commands
-    bool show(uint8_t position);
+    bool show(uint8_t position, const RgbColor& color = RGB_SHOW);
     bool hide(uint8_t position);
     void hideAll();
-    bool success(uint8_t position);
+    bool success(uint8_t position, const RgbColor& color = RGB_SUCCESS);
     bool fail(uint8_t position);
     bool contract(uint8_t position);
-    bool blink(uint8_t position);
+    bool blink(uint8_t position, const RgbColor& color = RGB_BLINK);
     bool stopBlink(uint8_t position);
     bool expandStep(uint8_t position);
     bool contractStep(uint8_t position);
+    bool expandTo(uint8_t position, uint8_t radius, uint16_t durationMs = 0);
+    bool hueCycle(uint8_t position, uint16_t periodMs = LED_HUE_CYCLE_DEFAULT_MS);
+    bool setMeter(uint8_t from, uint8_t to, uint8_t level, const RgbColor& color = RGB_SHOW);
+    bool spanContains(uint8_t from, uint8_t to, uint8_t position) const;
+    
+    // Scenes (SCENE_SLOTS)
+    bool storeScene(uint8_t slot);
+    bool recallScene(uint8_t slot);
+    
+    // Palette
+    bool setPaletteColor(uint8_t index, const RgbColor& color);
+    bool getPaletteColor(uint8_t index, RgbColor& color) const;
     
     // Sequence animation
     void startSequenceCompletedAnimation();
@@ -72,24 +145,65 @@ public:
     void startMenuChangeAnimation(uint8_t r, uint8_t g, uint8_t b, uint8_t range);
     bool isMenuChangeAnimationComplete() const;
     
+    // Pattern library
+    bool startPattern(uint8_t patternId);
+    bool isPatternComplete() const;
+    
     // State queries
     bool isAnimationComplete(uint8_t position) const;
     bool isContractComplete(uint8_t position) const;
     bool isBlinking(uint8_t position) const;
+    bool isExpandComplete(uint8_t position) const;
+    uint8_t getMaxRadius(uint8_t position) const;
+    
+    // Load shedding (overload governor)
+    void setMinFrameInterval(uint16_t ms);
+    void setSkipSteps(bool enabled);
+    
+    // Frame counter (incremented after every show() of both strips)
+    uint32_t getFrameCount() const;
+    uint32_t getLastFrameTime() const;
+    uint32_t getPendingFrame() const;  // Frame that will show the current composed state
+    bool getFrameTime(uint32_t frame, FrameTime& time) const;  // false once out of LED_FRAME_TIME_HISTORY
+    
+    // Framebuffer readback (logical RGB, before brightness scaling)
+    bool readPixels(StripId strip, uint16_t from, uint16_t count, uint8_t* rgb) const;
+    uint32_t frameHash(StripId strip) const;
+    uint16_t getStripLength(StripId strip) const;
     
     // Utilities
     static uint8_t charToPosition(char c);
     static char positionToChar(uint8_t pos);
+    static RgbColor hsvToRgb(uint8_t h, uint8_t s, uint8_t v);
 
 private:
     Adafruit_NeoPixel m_strip1;
     Adafruit_NeoPixel m_strip2;
     PositionData m_positions[LED_POSITION_COUNT];
+    uint8_t m_frame1[LED_STRIP_1_LENGTH * LED_FRAME_PIXEL_BYTES];  // Logical pixels (RGB or color index)
+    uint8_t m_frame2[LED_STRIP_2_LENGTH * LED_FRAME_PIXEL_BYTES];
+    RgbColor m_colorTable[LED_INDEXED_FRAMEBUFFER ? LED_COLOR_TABLE_SIZE : 1];  // Indexed mode only
+    uint8_t m_colorHash[LED_INDEXED_FRAMEBUFFER ? LED_COLOR_HASH_SIZE : 1];     // Table index per slot (0 = empty)
+    uint8_t m_colorCount;
+    uint8_t m_lastColorIndex;  // Most recently stored color, checked before the hash
+    bool m_colorTableCompacted;  // Compacted once since the last hand-over, don't repeat
+    RgbColor m_palette[LED_PALETTE_SIZE];
+    MeterData m_meters[LED_METER_SLOTS];
+    LedScene m_scenes[SCENE_SLOTS];
     
     bool m_sequenceAnimActive;
     uint8_t m_sequenceAnimStep;
     uint32_t m_sequenceAnimLastTime;
     bool m_needsUpdate;
+    volatile uint32_t m_frameCount;     // Frames shown (output stage)
+    volatile uint32_t m_lastFrameTime;
+    FrameTime m_frameTimes[LED_FRAME_TIME_HISTORY];  // Ring by frame number, written by the output stage
+    mutable portMUX_TYPE m_frameMux = portMUX_INITIALIZER_UNLOCKED;  // Guards frame count, times and hand-back
+    uint32_t m_handedFrameCount;        // Frames passed to the output stage (compose stage)
+    TaskHandle_t m_outputTask;
+    volatile bool m_outputBusy;         // Strip buffers belong to the output stage
+    volatile uint16_t m_minFrameMs;  // Frame rate cap (0 = show every change)
+    volatile bool m_skipSteps;       // Catch up on late animation steps without showing each
     
     // Menu change animation state
     bool m_menuChangeActive;
@@ -98,17 +212,43 @@ private:
     uint8_t m_menuChangeR, m_menuChangeG, m_menuChangeB;
     uint32_t m_menuChangeLastTime;
     
+    // Pattern playback state
+    bool m_patternActive;
+    uint8_t m_patternId;
+    uint16_t m_patternFrame;
+    uint32_t m_patternLastTime;
+    
     void update(uint32_t nowMillis);
+    void updateAnimations(uint32_t nowMillis);
+    uint8_t dueSteps(uint32_t& lastTime, uint32_t nowMillis, uint16_t stepMs) const;
     const LedMapping* getMapping(uint8_t position) const;
-    Adafruit_NeoPixel* getStrip(StripId strip);
-    uint16_t getStripLength(StripId strip) const;
+    uint8_t* getFrameBuffer(StripId strip);
+    const uint8_t* getFrameBuffer(StripId strip) const;
+    void clearStrips();
+    void loadPixel(StripId strip, uint16_t index, uint8_t* rgb) const;
+    uint8_t colorIndex(uint8_t r, uint8_t g, uint8_t b);
+    void compactColorTable();
+    void rebuildColorHash();
+    static uint8_t colorHashSlot(uint8_t r, uint8_t g, uint8_t b);
+    void loadOutputBuffers();
+    void showFrame();
     void setLed(StripId strip, int16_t index, uint8_t r, uint8_t g, uint8_t b);
+    void setLed(StripId strip, int16_t index, const RgbColor& color);
     void clearExpandedRegion(uint8_t position, const LedMapping* mapping);
     void updateAnimation(uint8_t position, uint32_t nowMillis);
     void updateContractAnimation(uint8_t position, uint32_t nowMillis);
     void updateBlinking(uint32_t nowMillis);
+    void updateHueCycle(uint8_t position, uint32_t nowMillis);
+    void updateExpandTo(uint8_t position, uint32_t nowMillis);
+    void setRing(const LedMapping* mapping, uint8_t radius, const RgbColor& color);
+    MeterData* findMeter(uint8_t from, uint8_t to);
+    void renderMeter(const MeterData& meter, uint16_t firstLed, uint16_t lastLed);
+    void clearMeters();
     void updateSequenceCompletedAnimation(uint32_t nowMillis);
     void updateMenuChangeAnimation(uint32_t nowMillis);
+    void updatePattern(uint32_t nowMillis);
+    void renderPatternFrame(StripId strip, const PatternDef& def, uint16_t frame);
+    static RgbColor gradientColor(uint8_t gradient, uint8_t position);
 };
 
 #endif // LED_CONTROLL
\ No newline at end of file
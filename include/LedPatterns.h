@@ -0,0 +1,68 @@
+/**
+ * @file LedPatterns.h
+ * @brief Built-in whole-board LED patterns (PATTERN <id>)
+ *
+ * Each pattern is a generator plus constant parameters. The tables are
+ * constexpr so they stay in flash; LedController evaluates the generator
+ * per pixel for every frame and writes the result straight to both strips.
+ * Add a pattern by appending a row to LED_PATTERNS.
+ */
+
+#ifndef LED_PATTERNS_H
+#define LED_PATTERNS_H
+
+#include <Arduino.h>
+
+// ============================================================================
+// Pattern Types
+// ============================================================================
+
+enum class PatternGenerator : uint8_t {
+    RAINBOW,    // Hue wheel across the strip, scrolled by param hue steps per frame
+    CHASE,      // Every param-th LED lit in color, moving one LED per frame
+    COMET,      // Head in color with a fading tail of param LEDs
+    BREATHE,    // Whole strip fades in and out, param frames per half period
+    GRADIENT,   // Scrolling gradient, param = row of LED_PATTERN_GRADIENTS
+    SPARKLE,    // Pseudo-random pixels in color, param = density (0-255)
+    WIPE        // Color fills the strip from index 0 over the pattern length
+};
+
+struct PatternDef {
+    PatternGenerator generator;
+    uint8_t r, g, b;        // Base color (unused by RAINBOW and GRADIENT)
+    uint8_t param;          // Generator-specific, see PatternGenerator
+    uint16_t frameMs;       // Time between frames
+    uint16_t frameCount;    // Frames until the pattern completes (DONE)
+};
+
+// ============================================================================
+// Gradients (4 evenly spaced RGB stops, wrapped around the strip)
+// ============================================================================
+
+constexpr uint8_t LED_PATTERN_GRADIENT_STOPS = 4;
+
+constexpr uint8_t LED_PATTERN_GRADIENTS[][LED_PATTERN_GRADIENT_STOPS][3] = {
+    { { 255,   0,   0 }, { 255, 96,   0 }, { 255, 200,  0 }, { 255,  32,   0 } },  // 0 fire
+    { {   0,  16, 128 }, {   0, 96, 255 }, {   0, 255, 192 }, {   0,  48, 160 } },  // 1 ocean
+    { { 255,   0, 128 }, { 128,  0, 255 }, {   0, 128, 255 }, { 255,  64,  64 } }   // 2 sunset
+};
+
+// ============================================================================
+// Pattern Catalog (id = row index)
+// ============================================================================
+
+constexpr PatternDef LED_PATTERNS[] = {
+    { PatternGenerator::RAINBOW,    0,   0,   0,   2, 20, 300 },  // 0 rainbow scroll, 6s
+    { PatternGenerator::CHASE,      0,   0, 255,   4, 40, 150 },  // 1 blue theater chase, 6s
+    { PatternGenerator::COMET,    255, 255, 255,  12, 15, 400 },  // 2 white comet, 6s
+    { PatternGenerator::BREATHE,    0, 255,   0,  50, 40, 200 },  // 3 green breathing, 8s
+    { PatternGenerator::GRADIENT,   0,   0,   0,   0, 30, 200 },  // 4 fire gradient, 6s
+    { PatternGenerator::GRADIENT,   0,   0,   0,   1, 30, 200 },  // 5 ocean gradient, 6s
+    { PatternGenerator::SPARKLE,  255, 255, 255,  20, 50, 120 },  // 6 white sparkle, 6s
+    { PatternGenerator::WIPE,     255,   0,   0,   0, 10, 100 },  // 7 red wipe, 1s
+    { PatternGenerator::GRADIENT,   0,   0,   0,   2, 30, 200 }   // 8 sunset gradient, 6s
+};
+
+constexpr uint8_t LED_PATTERN_COUNT = sizeof(LED_PATTERNS) / sizeof(LED_PATTERNS[0]);
+
+#endif // LED_PATTERNS_H
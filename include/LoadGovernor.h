@@ -0,0 +1,72 @@
+/**
+ * @file LoadGovernor.h
+ * @brief Overload governor: degrades output in a defined order under load
+ * 
+ * Watches event queue fill, serial RX backlog and main loop time, and
+ * steps through the shed levels below instead of letting events or input
+ * bytes drop silently. Every level change is reported with a LOAD event.
+ * Queued GET_FRAME chunks do not count towards event queue fill.
+ * 
+ *   0 NORMAL         - Nothing shed
+ *   1 FRAME_RATE     - LED frames at most every LOAD_REDUCED_FRAME_MS
+ *   2 SKIP_STEPS     - Animations jump to the step due instead of showing each one
+ *   3 COALESCE_ACKS  - Identical ACKs of commands without #id are merged (ACK ... +n)
+ *   4 REJECT         - New commands get BUSY (PING, INFO, HIDE_ALL still run)
+ * 
+ * Each level includes the ones below it.
+ */
+
+#ifndef LOAD_GOVERNOR_H
+#define LOAD_GOVERNOR_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+class LedController;
+class CommandController;
+class EventQueue;
+
+// ============================================================================
+// Types
+// ============================================================================
+
+enum class LoadLevel : uint8_t {
+    NORMAL,
+    FRAME_RATE,
+    SKIP_STEPS,
+    COALESCE_ACKS,
+    REJECT
+};
+
+// ============================================================================
+// LoadGovernor Class
+// ============================================================================
+
+class LoadGovernor {
+public:
+    LoadGovernor(LedController& ledController,
+                 CommandController& commandController,
+                 EventQueue& eventQueue);
+    
+    void begin();
+    void tick(uint32_t loopTimeUs);
+    
+    LoadLevel getLevel() const;
+    static const char* levelToString(LoadLevel level);
+
+private:
+    LedController& m_ledController;
+    CommandController& m_commandController;
+    EventQueue& m_eventQueue;
+    
+    LoadLevel m_level;
+    uint32_t m_lastEvalTime;
+    bool m_releasePending;       // Pressure is below the release threshold of m_level
+    uint32_t m_releaseStart;     // Since when (or since the last step down)
+    uint32_t m_peakLoopUs;       // Longest loop since the last evaluation
+    
+    static uint8_t levelThreshold(LoadLevel level);
+    void setLevel(LoadLevel level, uint8_t eventFill, uint8_t rxFill, uint32_t loopUs);
+};
+
+#endif // LOAD_GOVERNOR_H
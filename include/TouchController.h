@@ -2,10 +2,18 @@
  * @file TouchController.h
  * @brief Touch sensor controller for 25 CAP1188 capacitive touch sensors over I2C
  * 
+ * Sensors are discovered on the bus by product ID and mapped to positions
+ * through a persisted address map (see ASSIGN / ASSIGN_TOUCH).
+ * 
  * Protocol v2: Event-driven architecture
  * - Always polls sensors
  * - Debounces touch inputs
+ * - Suppresses cross-talk between adjacent positions
+ * - Accepts synthetic touch edges for load testing (INJECT)
  * - Emits TOUCHED/TOUCH_RELEASED events when expectations are fulfilled
+ * - Tracks peak delta and press duration per touch (TOUCH_REPORT_METRICS)
+ * - Drops sensors to standby when idle, wakes on expectation or touch
+ * - Recovers the I2C bus when every sensor stops answering (BUS_RECOVERED)
  */
 
 #ifndef TOUCH_CONTROLLER_H
@@ -13,6 +21,8 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 #include "Config.h"
 
 class EventQueue;
@@ -21,17 +31,132 @@ class EventQueue;
 // Types
 // ============================================================================
 
+enum class DebounceProfile : uint8_t {
+    NORMAL = 0,
+    FAST,
+    STRICT
+};
+
+constexpr uint8_t SENSITIVITY_UNCHANGED = 255;  // No SET_SENSITIVITY yet, chip keeps its default
+
 struct TouchSensorState {
     bool active;
     bool currentTouched;
     bool debouncedTouched;
     bool lastReportedTouched;
     uint32_t lastChangeTime;
+    uint32_t pressStartTime;  // Raw edge time of the current/last press
+    uint32_t pressStartMicros;        // Same edge in micros (REACT)
+    int8_t peakDelta;         // Highest delta sampled during the current/last press
+    bool crosstalkSuppressed;         // Lost arbitration to a neighbor, ignored until released
+    bool injectedTouched;             // Synthetic touch held by INJECT
+    bool syntheticEdge;               // Pending edge came from injection
+    int8_t lastDelta;                 // Delta read in the latest sweep (valid if deltaFresh)
+    bool deltaFresh;
+};
+
+enum class InjectPattern : uint8_t {
+    SEQUENCE = 0,  // Active sensors in order
+    RANDOM,        // One random active sensor per step
+    ALL            // Every active sensor at once
+};
+
+struct InjectedEdge {
+    uint8_t sensorIndex;
+    bool down;
+    uint32_t dueTime;
+};
+
+struct TouchEdge {
+    uint8_t sensorIndex;
+    uint32_t time;       // Raw press edge (ms), before debounce
+};
+
+struct InjectScript {
+    InjectPattern pattern;
+    uint16_t periodMs;
+    uint16_t holdMs;
+    uint16_t remaining;
+    uint32_t nextTime;
+    uint8_t cursor;
+};
+
+struct TouchStats {
+    uint32_t touched;     // Debounced press edges
+    uint32_t released;    // Debounced release edges
+    uint32_t synthetic;   // Of the above, caused by injection
+    uint32_t suppressed;  // Presses dropped by cross-talk arbitration
 };
 
 struct ExpectState {
     bool active;
     uint32_t commandId;
+    DebounceProfile profile;  // Debounce profile given with this expectation
+};
+
+struct TouchScene {
+    uint32_t expectDown;  // Armed expectations, one bit per sensor
+    uint32_t expectUp;
+    DebounceProfile downProfiles[TOUCH_SENSOR_COUNT];
+    DebounceProfile upProfiles[TOUCH_SENSOR_COUNT];
+};
+
+enum class SensorPowerMode : uint8_t {
+    ACTIVE,
+    STANDBY,
+    DEEP_SLEEP
+};
+
+enum class SensorRequestType : uint8_t {
+    VALUE,
+    RECALIBRATE,
+    RECALIBRATE_ALL,
+    SET_SENSITIVITY,
+    EXPECT_DOWN_LEVEL,  // Arm, then fire at once if already touched (level = profile)
+    EXPECT_UP_LEVEL     // Arm, then fire at once if already released
+};
+
+struct SensorRequest {
+    SensorRequestType type;
+    uint8_t sensorIndex;
+    uint8_t level;
+    uint8_t sequence;
+    uint32_t commandId;
+};
+
+// Outcome of a SensorRequest, handed back to Core 1 which sends the reply
+struct SensorResult {
+    SensorRequestType type;
+    uint8_t sensorIndex;
+    uint8_t sequence;
+    bool ok;
+    int8_t value;  // VALUE only
+    uint32_t commandId;
+};
+
+enum class BusRequestType : uint8_t {
+    NONE,
+    DISCOVER,
+    ASSIGN,
+    ASSIGN_TOUCH
+};
+
+enum class SelfTestPhase : uint8_t {
+    IDLE,
+    STARTING,
+    SAMPLING,
+    RECALIBRATING,
+    COMPLETE
+};
+
+struct SelfTestResult {
+    uint16_t samples;       // Successful delta reads
+    uint16_t errors;        // Failed I2C transactions
+    uint32_t i2cTotalUs;    // Sum of transaction times (for average)
+    uint16_t i2cMaxUs;      // Slowest transaction
+    int32_t deltaSum;
+    uint32_t deltaSumSq;
+    int32_t recalTimeMs;    // -1 while pending / on timeout
 };
 
 // ============================================================================
@@ -46,18 +171,35 @@ public:
     bool begin();
     void tick();
     
-    // Recalibration
-    bool recalibrate(uint8_t sensorIndex);
-    void recalibrateAll();
-    
-    // Sensitivity control
-    bool setSensitivity(uint8_t sensorIndex, uint8_t level);
+    // Sensor requests (applied on the touch task, outcome collected with takeSensorResult)
+    bool requestValue(uint8_t sensorIndex, uint32_t commandId);
+    bool requestRecalibrate(uint8_t sensorIndex, uint32_t commandId);
+    bool requestRecalibrateAll(uint32_t commandId);
+    bool requestSensitivity(uint8_t sensorIndex, uint8_t level, uint32_t commandId);
+    bool requestExpectLevel(uint8_t sensorIndex, bool down, uint32_t commandId,
+                            DebounceProfile profile = DebounceProfile::NORMAL);
+    bool takeSensorResult(SensorResult& result);
+    bool cancelSensorRequest();
     
     // Expectations
-    void setExpectDown(uint8_t sensorIndex, uint32_t commandId);
-    void setExpectUp(uint8_t sensorIndex, uint32_t commandId);
+    void setExpectDown(uint8_t sensorIndex, uint32_t commandId,
+                       DebounceProfile profile = DebounceProfile::NORMAL);
+    void setExpectUp(uint8_t sensorIndex, uint32_t commandId,
+                     DebounceProfile profile = DebounceProfile::NORMAL);
     void clearExpectDown(uint8_t sensorIndex);
     void clearExpectUp(uint8_t sensorIndex);
+    void storeExpectations(uint8_t slot);
+    void recallExpectations(uint8_t slot, uint32_t commandId);
+    
+    // Press stream for the main loop (SEQ_VERIFY), independent of expectations
+    void setEdgeListener(bool enabled);
+    bool takeTouchEdge(TouchEdge& edge);
+    
+    // Reaction timing (REACT): first raw press on one sensor after a start instant
+    void armReaction(uint8_t sensorIndex);
+    void startReaction(uint32_t startMicros);
+    void disarmReaction();
+    bool takeReaction(uint32_t& reactionUs);
     
     // State queries
     bool isSensorActive(uint8_t sensorIndex) const;
@@ -65,11 +207,32 @@ public:
     uint8_t getActiveSensorCount() const;
     void buildActiveSensorList(char* buffer, size_t bufferSize) const;
     
-    // Sensor value reading
-    bool readSensorValue(uint8_t sensorIndex, int8_t& value);
+    // Synthetic touch injection (applied on the touch task just before debounce)
+    bool injectTouch(uint8_t sensorIndex, bool down, uint16_t delayMs);
+    bool startInjectScript(InjectPattern pattern, uint16_t rateHz, uint16_t count, uint16_t holdMs);
+    void stopInjectScript();
+    bool isInjectScriptComplete() const;
+    bool didInjectScriptOverflow() const;
+    TouchStats getStats() const;
+    
+    // Discovery and position assignment (applied on the touch task)
+    bool requestDiscover(uint32_t commandId);
+    bool requestAssign(uint8_t address, uint8_t sensorIndex, uint32_t commandId);
+    bool requestAssignByTouch(uint8_t sensorIndex, uint32_t commandId);
+    uint8_t getSensorAddress(uint8_t sensorIndex) const;
+    
+    // Power policy
+    SensorPowerMode getPowerMode() const;
+    uint32_t getLastWakeLatencyUs() const;
+    
+    // Self-test (runs in the background on the touch task)
+    void startSelfTest();
+    bool isSelfTestComplete() const;
+    bool getSelfTestResult(uint8_t sensorIndex, SelfTestResult& result) const;
     
     // Utilities
     static uint8_t letterToIndex(char letter);
+    static uint16_t debounceWindowMs(DebounceProfile profile, bool press);
     static char indexToLetter(uint8_t index);
 
 private:
@@ -77,15 +240,121 @@ private:
     TouchSensorState m_sensors[TOUCH_SENSOR_COUNT];
     ExpectState m_expectDown[TOUCH_SENSOR_COUNT];
     ExpectState m_expectUp[TOUCH_SENSOR_COUNT];
+    TouchScene m_scenes[SCENE_SLOTS];  // Expectations per scene slot (SCENE_STORE)
     uint32_t m_lastPollTime;
     uint8_t m_activeSensorCount;
+    uint32_t m_adjacency[TOUCH_SENSOR_COUNT];  // Neighbor bitmask per sensor
+    uint8_t m_sensitivity[TOUCH_SENSOR_COUNT]; // Last SET_SENSITIVITY level, re-applied after bus recovery
+    
+    // Address map (0 = unassigned) and chips found by the last discovery pass
+    uint8_t m_addresses[TOUCH_SENSOR_COUNT];
+    uint32_t m_discovered[4];  // One bit per 7-bit address
+    uint8_t m_discoveredCount;
+    
+    // Injection state
+    QueueHandle_t m_injectQueue;
+    InjectedEdge m_pendingInjections[INJECT_PENDING_SIZE];
+    uint8_t m_pendingInjectionCount;
+    InjectScript m_script;
+    InjectScript m_scriptRequest;
+    volatile bool m_scriptRequested;
+    volatile bool m_scriptStopRequested;
+    volatile bool m_scriptActive;
+    volatile bool m_scriptOverflowed;  // A step did not fit in m_pendingInjections; run ended early
+    TouchStats m_stats;
+    
+    // VALUE / RECALIBRATE / SET_SENSITIVITY from Core 1, in arrival order, and their results
+    QueueHandle_t m_sensorRequestQueue;
+    QueueHandle_t m_sensorResultQueue;
+    uint8_t m_requestSequence;  // Core 1 only: last request submitted; older results are stale
+    // Sequence numbers skip 0, which marks "none"; both guarded by m_requestMux
+    uint8_t m_startedSequence;    // Last request the touch task took up
+    uint8_t m_cancelledSequence;  // Request Core 1 gave up on before it started
+    portMUX_TYPE m_requestMux = portMUX_INITIALIZER_UNLOCKED;
+    
+    // Debounced presses to Core 1 while a listener is set
+    QueueHandle_t m_edgeQueue;
+    volatile bool m_edgeListener;
+    
+    // Reaction probe: armed and started from Core 1, completed by the touch task.
+    // Every access goes through m_reactMux so the flags never run ahead of their data.
+    volatile bool m_reactArmed;
+    volatile bool m_reactStarted;
+    volatile bool m_reactDone;
+    uint8_t m_reactSensor;
+    uint32_t m_reactStartMicros;
+    uint32_t m_reactUs;
+    portMUX_TYPE m_reactMux = portMUX_INITIALIZER_UNLOCKED;
+    
+    // Pending discovery/assignment request from Core 1
+    volatile BusRequestType m_busRequest;
+    uint8_t m_busRequestAddress;
+    uint8_t m_busRequestSensor;
+    uint32_t m_busRequestCommandId;
+    uint32_t m_busRequestTime;
+    uint32_t m_assignPollTime;    // ASSIGN_TOUCH: last read of the unassigned chips
+    uint32_t m_assignHeld[4];     // ASSIGN_TOUCH: chips touched at that read, one bit per address
+    
+    // Power policy state
+    volatile SensorPowerMode m_powerMode;
+    volatile bool m_wakeRequested;
+    volatile uint32_t m_wakeRequestMicros;
+    uint32_t m_lastActivityTime;
+    uint32_t m_lastWakeLatencyUs;
+    
+    // Bus health (touch task only)
+    uint8_t m_failedSweeps;        // Consecutive sweeps in which no sensor answered
+    uint32_t m_busFailTime;        // First failed sweep of the current outage
+    uint32_t m_lastRecoveryTime;   // Last recovery attempt (0 = none this outage)
+    
+    // Self-test state (phase is written by both cores, results only by the touch task)
+    volatile SelfTestPhase m_selfTestPhase;
+    uint16_t m_selfTestSampleCount;
+    uint32_t m_selfTestRecalStart;
+    SelfTestResult m_selfTestResults[TOUCH_SENSOR_COUNT];
     
     bool initSensor(uint8_t address);
+    bool recalibrate(uint8_t sensorIndex);
+    void recalibrateAll();
+    bool setSensitivity(uint8_t sensorIndex, uint8_t level);
+    bool readSensorValue(uint8_t sensorIndex, int8_t& value);
+    bool submitSensorRequest(SensorRequestType type, uint8_t sensorIndex, uint8_t level, uint32_t commandId);
+    void processSensorRequests();
+    void checkReaction();
     bool readRegister(uint8_t address, uint8_t reg, uint8_t& value);
     bool writeRegister(uint8_t address, uint8_t reg, uint8_t value);
+    bool readDelta(uint8_t address, int8_t& value);
     int8_t readRawTouch(uint8_t address);  // Returns -1 on error, 0 = not touched, 1 = touched
-    void pollSensors();
+    bool pollSensors();
+    bool busLinesIdle() const;
+    void checkBusHealth(bool responded, uint32_t now);
+    bool releaseBus();
+    uint8_t recoverBus();
     void processDebounce();
+    void suppressCrosstalk();
+    void processInjections(uint32_t now);
+    void runInjectScript(uint32_t now);
+    bool hasPendingInjectionRoom(uint8_t edges) const;
+    void schedulePendingInjection(uint8_t sensorIndex, bool down, uint32_t dueTime);
+    void applyInjectedEdge(uint8_t sensorIndex, bool down, uint32_t now);
+    
+    void loadAddressMap();
+    void saveAddressMap();
+    void discoverSensors();
+    void refreshActiveSensors();
+    bool isDiscovered(uint8_t address) const;
+    int8_t findSensorByAddress(uint8_t address) const;
+    void assignAddress(uint8_t address, uint8_t sensorIndex);
+    void resetSensorState(uint8_t sensorIndex);
+    void processBusRequest(uint32_t now);
+    uint8_t buildUnassignedList(char* buffer, size_t bufferSize, uint8_t firstAddress) const;
+    DebounceProfile edgeProfile(uint8_t sensorIndex, bool press) const;
+    void reportExpectDown(uint8_t sensorIndex, bool levelSatisfied);
+    void reportExpectUp(uint8_t sensorIndex, bool levelSatisfied);
+    void runSelfTest(uint32_t now);
+    void updatePowerPolicy(uint32_t now);
+    void setPowerMode(SensorPowerMode mode, uint32_t wakeStartMicros);
+    void requestWake();
 };
 
 #endif // TOUCH_CONTROLLER
\ No newline at end of file
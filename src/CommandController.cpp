@@ -26,6 +26,24 @@ CommandController::CommandController(LedController& ledController,
     , m_lastRxTime(0)
     , m_lineIndex(0)
     , m_lineOverflow(false)
+    , m_parsedQueue(nullptr)
+    , m_rejectNew(false)
+    , m_sensorRequestPending(false)
+    , m_sensorRequestTime(0)
+    , m_sensorRequestId(COMMAND_ID_NONE)
+    , m_heldHead(0)
+    , m_heldCount(0)
+    , m_frameSyncEvery(0)
+    , m_lastSyncedFrame(0)
+    , m_readbackActive(false)
+    , m_readbackStrip(0)
+    , m_readbackLastStrip(0)
+    , m_readbackNext(0)
+    , m_readbackEnd(0)
+    , m_readbackLastEnd(0)
+    , m_seqVerifyActive(false)
+    , m_seqVerifyMiss(0)
+    , m_reactActive(false)
 {
     memset(m_rxBuffer, 0, sizeof(m_rxBuffer));
     memset(m_lineBuffer, 0, sizeof(m_lineBuffer));
@@ -45,6 +63,19 @@ void CommandController::begin() {
     m_lastRxTime = 0;
     m_lineIndex = 0;
     m_lineOverflow = false;
+    m_frameSyncEvery = 0;
+    m_lastSyncedFrame = 0;
+    m_readbackActive = false;
+    m_seqVerifyActive = false;
+    m_reactActive = false;
+    m_rejectNew = false;
+    m_sensorRequestPending = false;
+    m_heldHead = 0;
+    m_heldCount = 0;
+    
+    if (!m_parsedQueue) {
+        m_parsedQueue = xQueueCreate(SERIAL_PARSED_QUEUE_SIZE, sizeof(ParsedCommand));
+    }
     
     for (uint8_t i = 0; i < QUEUE_SIZE_COMMANDS; i++) {
         m_commandQueue[i].active = false;
@@ -66,13 +97,164 @@ void CommandController::pollSerial() {
 }
 
 void CommandController::processCompletedLines() {
+    while (resumeHeldCommands() && extractLine()) {
+        if (m_lineBuffer[0] != '\0') {
+            ParsedCommand cmd;
+            parseLine(m_lineBuffer, cmd);
+            dispatchCommand(cmd);
+        }
+    }
+}
+
+/**
+ * @brief Serial task side: parses completed lines and queues them for execution
+ * 
+ * Lines that fail to parse are queued too, so their ERR keeps its place
+ * among the responses. Blocks while the queue is full, which leaves further
+ * input in the UART buffer until the main loop catches up.
+ */
+void CommandController::parseCompletedLines() {
     while (extractLine()) {
         if (m_lineBuffer[0] != '\0') {
             ParsedCommand cmd;
-            if (parseLine(m_lineBuffer, cmd)) {
-                executeCommand(cmd);
-            }
+            parseLine(m_lineBuffer, cmd);
+            xQueueSend(m_parsedQueue, &cmd, portMAX_DELAY);
+        }
+    }
+}
+
+/**
+ * @brief Main loop side: executes commands queued by parseCompletedLines()
+ */
+void CommandController::executeParsedCommands() {
+    ParsedCommand cmd;
+    while (resumeHeldCommands() && m_parsedQueue && xQueueReceive(m_parsedQueue, &cmd, 0) == pdTRUE) {
+        dispatchCommand(cmd);
+    }
+}
+
+/**
+ * @brief Executes a command, or holds it back behind the outstanding sensor request
+ * 
+ * Only commands that use the sensors wait, in arrival order, so sensor
+ * replies keep their order among each other. LED and system commands
+ * keep running.
+ */
+void CommandController::dispatchCommand(const ParsedCommand& cmd) {
+    if (waitsForSensorRequest(cmd.action) && (m_sensorRequestPending || m_heldCount > 0)) {
+        m_heldCommands[(m_heldHead + m_heldCount) % TOUCH_REQUEST_QUEUE_SIZE] = cmd;
+        m_heldCount++;
+        return;
+    }
+    executeCommand(cmd);
+}
+
+/**
+ * @brief Runs held sensor commands once their predecessor is answered
+ * @return false while the held commands are full (reading new commands waits)
+ */
+bool CommandController::resumeHeldCommands() {
+    pollSensorReply();
+    while (!m_sensorRequestPending && m_heldCount > 0) {
+        const ParsedCommand& cmd = m_heldCommands[m_heldHead];
+        m_heldHead = (m_heldHead + 1) % TOUCH_REQUEST_QUEUE_SIZE;
+        m_heldCount--;
+        executeCommand(cmd);
+    }
+    return m_heldCount < TOUCH_REQUEST_QUEUE_SIZE;
+}
+
+/**
+ * @brief Commands that must not overtake an outstanding sensor request
+ */
+bool CommandController::waitsForSensorRequest(CommandAction action) {
+    switch (action) {
+        case CommandAction::EXPECT:
+        case CommandAction::EXPECT_RELEASE:
+        case CommandAction::RECALIBRATE:
+        case CommandAction::RECALIBRATE_ALL:
+        case CommandAction::SET_SENSITIVITY:
+        case CommandAction::VALUE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Marks a request handed to the touch task as pending (BUSY if it was not accepted)
+ */
+void CommandController::awaitSensorRequest(bool submitted, uint32_t cmdId) {
+    if (!submitted) {
+        m_eventQueue.queueBusy(cmdId);
+        return;
+    }
+    m_sensorRequestPending = true;
+    m_sensorRequestTime = millis();
+    m_sensorRequestId = cmdId;
+}
+
+/**
+ * @brief Sends the reply of a finished sensor request
+ * 
+ * VALUE, RECALIBRATE and SET_SENSITIVITY run on the touch task; their
+ * reply is queued here once the result is back. LEVEL expectations are
+ * acknowledged by the touch task itself. A
+ * request the touch task has not started within TOUCH_REQUEST_TIMEOUT_MS
+ * is cancelled and answered with ERR sensor_timeout. One that has started
+ * is waited for, so the host never hears "failed" for a request that
+ * took effect.
+ */
+void CommandController::pollSensorReply() {
+    if (!m_sensorRequestPending) return;
+    
+    SensorResult result;
+    if (m_touchController->takeSensorResult(result)) {
+        m_sensorRequestPending = false;
+        
+        char letter = TouchController::indexToLetter(result.sensorIndex);
+        uint32_t cmdId = result.commandId;
+        switch (result.type) {
+            case SensorRequestType::VALUE:
+                if (result.ok) {
+                    m_eventQueue.queueValue(letter, result.value, cmdId);
+                } else {
+                    m_eventQueue.queueError("sensor_inactive", cmdId);
+                }
+                break;
+                
+            case SensorRequestType::RECALIBRATE:
+                if (result.ok) {
+                    m_eventQueue.queueAck(actionToString(CommandAction::RECALIBRATE), letter, cmdId);
+                    m_eventQueue.queueRecalibrated(letter, cmdId);
+                } else {
+                    m_eventQueue.queueError("command_failed", cmdId);
+                }
+                break;
+                
+            case SensorRequestType::RECALIBRATE_ALL:
+                m_eventQueue.queueAck(actionToString(CommandAction::RECALIBRATE_ALL), 0, cmdId);
+                m_eventQueue.queueRecalibrated(0, cmdId);
+                break;
+                
+            case SensorRequestType::SET_SENSITIVITY:
+                if (result.ok) {
+                    m_eventQueue.queueAck(actionToString(CommandAction::SET_SENSITIVITY), letter, cmdId);
+                } else {
+                    m_eventQueue.queueError("command_failed", cmdId);
+                }
+                break;
+                
+            default:
+                break;
         }
+        return;
+    }
+    
+    if (millis() - m_sensorRequestTime >= TOUCH_REQUEST_TIMEOUT_MS &&
+        m_touchController->cancelSensorRequest()) {
+        m_sensorRequestPending = false;
+        m_eventQueue.queueError("sensor_timeout", m_sensorRequestId);
     }
 }
 
@@ -83,6 +265,10 @@ void CommandController::tick() {
             tickCommand(m_commandQueue[i]);
         }
     }
+    
+    if (m_frameSyncEvery > 0) {
+        tickFrameSync();
+    }
 }
 
 bool CommandController::isQueueFull() const {
@@ -94,6 +280,34 @@ bool CommandController::isQueueFull() const {
     return true;
 }
 
+bool CommandController::hasActiveCommands() const {
+    for (uint8_t i = 0; i < QUEUE_SIZE_COMMANDS; i++) {
+        if (m_commandQueue[i].active) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Fullest stage of the receive path in percent
+ * 
+ * Covers bytes waiting in the UART driver, the line ring buffer and parsed
+ * commands not yet executed; any of them filling up means input is about
+ * to be dropped or stalled.
+ */
+uint8_t CommandController::getRxFillPercent() const {
+    uint16_t uartFill = min<uint32_t>((uint32_t)Serial.available() * 100 / SERIAL_RX_BUFFER_SIZE, 100);
+    uint16_t ringUsed = (m_rxHead + sizeof(m_rxBuffer) - m_rxTail) % sizeof(m_rxBuffer);
+    uint16_t ringFill = ringUsed * 100 / (sizeof(m_rxBuffer) - 1);
+    uint16_t parsedFill = m_parsedQueue ? uxQueueMessagesWaiting(m_parsedQueue) * 100 / SERIAL_PARSED_QUEUE_SIZE : 0;
+    return (uint8_t)max(uartFill, max(ringFill, parsedFill));
+}
+
+void CommandController::setRejectNew(bool enabled) {
+    m_rejectNew = enabled;
+}
+
 // ============================================================================
 // Line Extraction
 // ============================================================================
@@ -140,11 +354,19 @@ bool CommandController::parseLine(const char* line, ParsedCommand& cmd) {
     cmd.hasId = false;
     cmd.id = COMMAND_ID_NONE;
     cmd.extraValue = 0;
+    cmd.level = false;
+    cmd.reportDone = false;
+    cmd.hasColor = false;
     cmd.r = 0;
     cmd.g = 0;
     cmd.b = 0;
+    cmd.paletteIndex = PALETTE_INDEX_NONE;
     cmd.range = 0;
+    cmd.argCount = 0;
+    memset(cmd.args, 0, sizeof(cmd.args));
+    cmd.stepCount = 0;
     cmd.valid = false;
+    cmd.error = nullptr;
     
     const char* p = skipWhitespace(line);
     if (*p == '\0') return false;
@@ -156,67 +378,83 @@ bool CommandController::parseLine(const char* line, ParsedCommand& cmd) {
     
     cmd.action = parseAction(actionStart, actionLen);
     if (cmd.action == CommandAction::INVALID) {
-        m_eventQueue.queueError("unknown_action", COMMAND_ID_NONE);
+        cmd.error = "unknown_action";
         return false;
     }
     
     p = skipWhitespace(actionEnd);
     
-    // Special parsing for MENUE_CHANGE: <r,g,b> <range>
+    // Special parsing for MENUE_CHANGE: <color> <range>
     if (cmd.action == CommandAction::MENUE_CHANGE) {
-        // Parse R value
-        uint16_t val = 0;
-        while (*p >= '0' && *p <= '9') {
-            val = val * 10 + (*p - '0');
-            p++;
+        const char* colorEnd = findTokenEnd(p);
+        if (!parseColor(p, colorEnd - p, cmd)) {
+            cmd.error = "bad_format";
+            return false;
         }
-        if (val > 255) { m_eventQueue.queueError("bad_format", COMMAND_ID_NONE); return false; }
-        cmd.r = (uint8_t)val;
-        
-        if (*p != ',') { m_eventQueue.queueError("bad_format", COMMAND_ID_NONE); return false; }
-        p++;
+        cmd.hasColor = true;
+        p = skipWhitespace(colorEnd);
         
-        // Parse G value
-        val = 0;
+        // Parse range
+        uint16_t val = 0;
         while (*p >= '0' && *p <= '9') {
             val = val * 10 + (*p - '0');
             p++;
         }
-        if (val > 255) { m_eventQueue.queueError("bad_format", COMMAND_ID_NONE); return false; }
-        cmd.g = (uint8_t)val;
-        
-        if (*p != ',') { m_eventQueue.queueError("bad_format", COMMAND_ID_NONE); return false; }
-        p++;
+        if (val > 255) { cmd.error = "bad_format"; return false; }
+        cmd.range = (uint8_t)val;
         
-        // Parse B value
-        val = 0;
+        p = skipWhitespace(p);
+    }
+    
+    // PALETTE: <index> <color>
+    if (cmd.action == CommandAction::PALETTE) {
+        uint16_t val = 0;
+        const char* digitsStart = p;
         while (*p >= '0' && *p <= '9') {
             val = val * 10 + (*p - '0');
             p++;
         }
-        if (val > 255) { m_eventQueue.queueError("bad_format", COMMAND_ID_NONE); return false; }
-        cmd.b = (uint8_t)val;
-        
+        if (p == digitsStart || val >= LED_PALETTE_SIZE) {
+            cmd.error = "bad_format";
+            return false;
+        }
+        cmd.extraValue = (uint8_t)val;
         p = skipWhitespace(p);
         
-        // Parse range
-        val = 0;
-        while (*p >= '0' && *p <= '9') {
-            val = val * 10 + (*p - '0');
-            p++;
+        const char* colorEnd = findTokenEnd(p);
+        if (!parseColor(p, colorEnd - p, cmd)) {
+            cmd.error = "bad_format";
+            return false;
+        }
+        cmd.hasColor = true;
+        p = skipWhitespace(colorEnd);
+    }
+    
+    // ASSIGN takes the I2C address (hex, optional 0x prefix) before the position
+    if (cmd.action == CommandAction::ASSIGN) {
+        if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) p += 2;
+        
+        uint16_t val = 0;
+        uint8_t digits = 0;
+        for (;; p++, digits++) {
+            char c = (*p >= 'a' && *p <= 'f') ? (*p - 32) : *p;
+            if (c >= '0' && c <= '9') val = val * 16 + (c - '0');
+            else if (c >= 'A' && c <= 'F') val = val * 16 + (c - 'A' + 10);
+            else break;
         }
-        if (val > 255) { m_eventQueue.queueError("bad_format", COMMAND_ID_NONE); return false; }
-        cmd.range = (uint8_t)val;
         
+        if (digits == 0 || val > 0x7F) {
+            cmd.error = "bad_format";
+            return false;
+        }
+        cmd.extraValue = (uint8_t)val;
         p = skipWhitespace(p);
-        cmd.valid = true;
-        return true;
     }
     
     // Parse position (if applicable)
     if (actionRequiresPosition(cmd.action)) {
         if (*p == '\0' || *p == '#') {
-            m_eventQueue.queueError("bad_format", COMMAND_ID_NONE);
+            cmd.error = "bad_format";
             return false;
         }
         
@@ -224,7 +462,7 @@ bool CommandController::parseLine(const char* line, ParsedCommand& cmd) {
         cmd.positionIndex = charToIndex(cmd.position);
         
         if (cmd.positionIndex == 255) {
-            m_eventQueue.queueError("unknown_position", COMMAND_ID_NONE);
+            cmd.error = "unknown_position";
             return false;
         }
         
@@ -235,7 +473,7 @@ bool CommandController::parseLine(const char* line, ParsedCommand& cmd) {
     // Parse extra numeric value if needed (e.g., sensitivity level)
     if (cmd.action == CommandAction::SET_SENSITIVITY) {
         if (*p == '\0' || *p == '#') {
-            m_eventQueue.queueError("bad_format", COMMAND_ID_NONE);
+            cmd.error = "bad_format";
             return false;
         }
         
@@ -246,7 +484,7 @@ bool CommandController::parseLine(const char* line, ParsedCommand& cmd) {
         }
         
         if (val > 7) {
-            m_eventQueue.queueError("invalid_level", COMMAND_ID_NONE);
+            cmd.error = "invalid_level";
             return false;
         }
         
@@ -254,6 +492,204 @@ bool CommandController::parseLine(const char* line, ParsedCommand& cmd) {
         p = skipWhitespace(p);
     }
     
+    // METER: <to_pos> <level> before the optional color
+    if (cmd.action == CommandAction::METER) {
+        char to = (*p >= 'a' && *p <= 'z') ? (*p - 32) : *p;
+        cmd.extraValue = charToIndex(to);
+        if (cmd.extraValue == 255) {
+            cmd.error = *p == '\0' || *p == '#' ? "bad_format" : "unknown_position";
+            return false;
+        }
+        p = skipWhitespace(p + 1);
+        
+        uint16_t val = 0;
+        const char* digitsStart = p;
+        while (*p >= '0' && *p <= '9' && val <= 255) {
+            val = val * 10 + (*p - '0');
+            p++;
+        }
+        if (p == digitsStart || val > 255) {
+            cmd.error = "bad_format";
+            return false;
+        }
+        cmd.args[0] = val;
+        cmd.argCount = 1;
+        p = skipWhitespace(p);
+    }
+    
+    // Parse optional color for LED commands
+    if (cmd.action == CommandAction::SHOW || cmd.action == CommandAction::SUCCESS ||
+        cmd.action == CommandAction::BLINK || cmd.action == CommandAction::METER) {
+        const char* colorEnd = findTokenEnd(p);
+        if (isColorToken(p, colorEnd - p)) {
+            if (!parseColor(p, colorEnd - p, cmd)) {
+                cmd.error = "bad_format";
+                return false;
+            }
+            cmd.hasColor = true;
+            p = skipWhitespace(colorEnd);
+        }
+    }
+    
+    // SHOW / FAIL / BLINK: [duration_ms [DONE]] after the optional color
+    if (cmd.action == CommandAction::SHOW || cmd.action == CommandAction::FAIL ||
+        cmd.action == CommandAction::BLINK) {
+        bool argsOk = parseNumericArgs(p, cmd);
+        if (!argsOk && cmd.argCount == 1) {
+            // Numbers stop at the first other token, which may be DONE
+            const char* doneEnd = findTokenEnd(p);
+            if (strcasecmpN(p, "DONE", doneEnd - p)) {
+                cmd.reportDone = true;
+                p = skipWhitespace(doneEnd);
+                argsOk = (*p == '\0' || *p == '#');
+            }
+        }
+        if (!argsOk || cmd.argCount > 1 || (cmd.argCount == 1 && cmd.args[0] == 0)) {
+            cmd.error = "bad_format";
+            return false;
+        }
+    }
+    
+    // EXPAND_TO: <radius> [ms]
+    if (cmd.action == CommandAction::EXPAND_TO) {
+        if (!parseNumericArgs(p, cmd) || cmd.argCount < 1 || cmd.argCount > 2 || cmd.args[0] > 255) {
+            cmd.error = "bad_format";
+            return false;
+        }
+    }
+    
+    // HUE_CYCLE: [period_ms]
+    if (cmd.action == CommandAction::HUE_CYCLE) {
+        if (!parseNumericArgs(p, cmd) || cmd.argCount > 1 || (cmd.argCount == 1 && cmd.args[0] == 0)) {
+            cmd.error = "bad_format";
+            return false;
+        }
+    }
+    
+    // PATTERN: <pattern_id>
+    if (cmd.action == CommandAction::PATTERN) {
+        if (!parseNumericArgs(p, cmd) || cmd.argCount != 1) {
+            cmd.error = "bad_format";
+            return false;
+        }
+        if (cmd.args[0] >= LED_PATTERN_COUNT) {
+            cmd.error = "unknown_pattern";
+            return false;
+        }
+    }
+    
+    // GET_FRAME: [strip] [from] [count], FRAME_HASH: [strip]
+    if (cmd.action == CommandAction::GET_FRAME || cmd.action == CommandAction::FRAME_HASH) {
+        uint8_t maxArgs = (cmd.action == CommandAction::GET_FRAME) ? 3 : 1;
+        if (!parseNumericArgs(p, cmd) || cmd.argCount > maxArgs ||
+            (cmd.argCount > 0 && (cmd.args[0] < 1 || cmd.args[0] > 2))) {
+            cmd.error = "bad_format";
+            return false;
+        }
+    }
+    
+    // SCENE_STORE / SCENE_RECALL: <slot>
+    if (cmd.action == CommandAction::SCENE_STORE || cmd.action == CommandAction::SCENE_RECALL) {
+        if (!parseNumericArgs(p, cmd) || cmd.argCount != 1 || cmd.args[0] >= SCENE_SLOTS) {
+            cmd.error = "bad_format";
+            return false;
+        }
+    }
+    
+    // SEQ_PLAY: <positions> <on_ms> <gap_ms>, SEQ_VERIFY: <positions> <timeout_ms>
+    if (cmd.action == CommandAction::SEQ_PLAY || cmd.action == CommandAction::SEQ_VERIFY) {
+        const char* stepsEnd = findTokenEnd(p);
+        if (p == stepsEnd || *p == '#' || stepsEnd - p > SEQ_MAX_STEPS) {
+            cmd.error = "bad_format";
+            return false;
+        }
+        for (; p < stepsEnd; p++) {
+            uint8_t index = charToIndex(*p);
+            if (index == 255) {
+                cmd.error = "unknown_position";
+                return false;
+            }
+            cmd.steps[cmd.stepCount++] = index;
+        }
+        p = skipWhitespace(stepsEnd);
+        
+        uint8_t argsNeeded = (cmd.action == CommandAction::SEQ_PLAY) ? 2 : 1;
+        if (!parseNumericArgs(p, cmd) || cmd.argCount != argsNeeded || cmd.args[0] == 0) {
+            cmd.error = "bad_format";
+            return false;
+        }
+    }
+    
+    // REACT: [timeout_ms]
+    if (cmd.action == CommandAction::REACT) {
+        if (!parseNumericArgs(p, cmd) || cmd.argCount > 1 || (cmd.argCount == 1 && cmd.args[0] == 0)) {
+            cmd.error = "bad_format";
+            return false;
+        }
+    }
+    
+    // FRAME_SYNC: <every_n>
+    if (cmd.action == CommandAction::FRAME_SYNC) {
+        if (!parseNumericArgs(p, cmd) || cmd.argCount != 1) {
+            cmd.error = "bad_format";
+            return false;
+        }
+    }
+    
+    // Parse optional debounce profile and LEVEL for expectations
+    if (cmd.action == CommandAction::EXPECT || cmd.action == CommandAction::EXPECT_RELEASE) {
+        if (*p != '\0' && *p != '#') {
+            const char* profileEnd = findTokenEnd(p);
+            if (!strcasecmpN(p, "LEVEL", profileEnd - p)) {
+                if (!parseDebounceProfile(p, profileEnd - p, cmd.extraValue)) {
+                    cmd.error = "bad_format";
+                    return false;
+                }
+                p = skipWhitespace(profileEnd);
+            }
+        }
+        
+        const char* levelEnd = findTokenEnd(p);
+        if (strcasecmpN(p, "LEVEL", levelEnd - p)) {
+            cmd.level = true;
+            p = skipWhitespace(levelEnd);
+        }
+    }
+    
+    // INJECT: DOWN|UP [delay_ms]
+    if (cmd.action == CommandAction::INJECT) {
+        const char* modeEnd = findTokenEnd(p);
+        if (strcasecmpN(p, "DOWN", modeEnd - p)) {
+            cmd.extraValue = 1;
+        } else if (strcasecmpN(p, "UP", modeEnd - p)) {
+            cmd.extraValue = 0;
+        } else {
+            cmd.error = "bad_format";
+            return false;
+        }
+        p = skipWhitespace(modeEnd);
+        
+        if (!parseNumericArgs(p, cmd) || cmd.argCount > 1) {
+            cmd.error = "bad_format";
+            return false;
+        }
+    }
+    
+    // INJECT_RUN: <pattern> <rate_hz> <count> [hold_ms]
+    if (cmd.action == CommandAction::INJECT_RUN) {
+        const char* patternEnd = findTokenEnd(p);
+        if (!parseInjectPattern(p, patternEnd - p, cmd.extraValue)) {
+            cmd.error = "bad_format";
+            return false;
+        }
+        p = skipWhitespace(patternEnd);
+        
+        if (!parseNumericArgs(p, cmd) || cmd.argCount < 2 || cmd.argCount > 3) {
+            cmd.error = "bad_format";
+            return false;
+        }
+    }
+    
     // Parse optional command ID (#number)
     if (*p == '#') {
         p++;
@@ -291,9 +727,134 @@ CommandAction CommandController::parseAction(const char* str, size_t len) {
     if (strcasecmpN(str, "SEQUENCE_COMPLETED", len)) return CommandAction::SEQUENCE_COMPLETED;
     if (strcasecmpN(str, "INFO", len)) return CommandAction::INFO;
     if (strcasecmpN(str, "PING", len)) return CommandAction::PING;
+    if (strcasecmpN(str, "SELFTEST", len)) return CommandAction::SELFTEST;
+    if (strcasecmpN(str, "DISCOVER", len)) return CommandAction::DISCOVER;
+    if (strcasecmpN(str, "ASSIGN", len)) return CommandAction::ASSIGN;
+    if (strcasecmpN(str, "ASSIGN_TOUCH", len)) return CommandAction::ASSIGN_TOUCH;
+    if (strcasecmpN(str, "INJECT", len)) return CommandAction::INJECT;
+    if (strcasecmpN(str, "INJECT_RUN", len)) return CommandAction::INJECT_RUN;
+    if (strcasecmpN(str, "INJECT_STOP", len)) return CommandAction::INJECT_STOP;
+    if (strcasecmpN(str, "STATS", len)) return CommandAction::STATS;
+    if (strcasecmpN(str, "PALETTE", len)) return CommandAction::PALETTE;
+    if (strcasecmpN(str, "HUE_CYCLE", len)) return CommandAction::HUE_CYCLE;
+    if (strcasecmpN(str, "PATTERN", len)) return CommandAction::PATTERN;
+    if (strcasecmpN(str, "FRAME_SYNC", len)) return CommandAction::FRAME_SYNC;
+    if (strcasecmpN(str, "GET_FRAME", len)) return CommandAction::GET_FRAME;
+    if (strcasecmpN(str, "FRAME_HASH", len)) return CommandAction::FRAME_HASH;
+    if (strcasecmpN(str, "EXPAND_TO", len)) return CommandAction::EXPAND_TO;
+    if (strcasecmpN(str, "METER", len)) return CommandAction::METER;
+    if (strcasecmpN(str, "SCENE_STORE", len)) return CommandAction::SCENE_STORE;
+    if (strcasecmpN(str, "SCENE_RECALL", len)) return CommandAction::SCENE_RECALL;
+    if (strcasecmpN(str, "SEQ_PLAY", len)) return CommandAction::SEQ_PLAY;
+    if (strcasecmpN(str, "SEQ_VERIFY", len)) return CommandAction::SEQ_VERIFY;
+    if (strcasecmpN(str, "REACT", len)) return CommandAction::REACT;
     return CommandAction::INVALID;
 }
 
+bool CommandController::parseDebounceProfile(const char* str, size_t len, uint8_t& profile) {
+    if (strcasecmpN(str, "NORMAL", len)) { profile = (uint8_t)DebounceProfile::NORMAL; return true; }
+    if (strcasecmpN(str, "FAST", len)) { profile = (uint8_t)DebounceProfile::FAST; return true; }
+    if (strcasecmpN(str, "STRICT", len)) { profile = (uint8_t)DebounceProfile::STRICT; return true; }
+    return false;
+}
+
+bool CommandController::parseInjectPattern(const char* str, size_t len, uint8_t& pattern) {
+    if (strcasecmpN(str, "SEQ", len)) { pattern = (uint8_t)InjectPattern::SEQUENCE; return true; }
+    if (strcasecmpN(str, "RANDOM", len)) { pattern = (uint8_t)InjectPattern::RANDOM; return true; }
+    if (strcasecmpN(str, "ALL", len)) { pattern = (uint8_t)InjectPattern::ALL; return true; }
+    return false;
+}
+
+/**
+ * @brief Parses up to 4 whitespace-separated decimal values (0-65535) into cmd.args
+ * 
+ * Stops at '#' or end of line. Returns false on a malformed or oversized value.
+ */
+bool CommandController::parseNumericArgs(const char*& p, ParsedCommand& cmd) {
+    while (*p != '\0' && *p != '#') {
+        if (*p < '0' || *p > '9' || cmd.argCount >= 4) return false;
+        
+        uint32_t val = 0;
+        while (*p >= '0' && *p <= '9') {
+            val = val * 10 + (*p - '0');
+            if (val > 0xFFFF) return false;
+            p++;
+        }
+        
+        cmd.args[cmd.argCount++] = (uint16_t)val;
+        p = skipWhitespace(p);
+    }
+    return true;
+}
+
+bool CommandController::isColorToken(const char* str, size_t len) {
+    if (len == 0) return false;
+    if (str[0] == '@' || str[0] == 'H' || str[0] == 'h') return true;
+    return memchr(str, ',', len) != nullptr;
+}
+
+/**
+ * @brief Parses a comma-separated list of 0-255 values
+ * @return Number of values parsed, or -1 if malformed
+ */
+int8_t CommandController::parseByteList(const char* str, size_t len, uint8_t* values, uint8_t maxValues) {
+    const char* end = str + len;
+    uint8_t count = 0;
+    
+    while (str < end) {
+        if (count >= maxValues || *str < '0' || *str > '9') return -1;
+        
+        uint16_t val = 0;
+        while (str < end && *str >= '0' && *str <= '9') {
+            val = val * 10 + (*str - '0');
+            if (val > 255) return -1;
+            str++;
+        }
+        values[count++] = (uint8_t)val;
+        
+        if (str < end) {
+            if (*str != ',') return -1;
+            str++;
+            if (str == end) return -1;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Parses a color token into RGB
+ * 
+ * Accepted forms:
+ *   r,g,b              - decimal RGB
+ *   @<i>               - device palette entry (looked up when the command executes)
+ *   H<h>[,<s>[,<v>]]   - HSV on an 8-bit hue wheel (s and v default to 255)
+ */
+bool CommandController::parseColor(const char* str, size_t len, ParsedCommand& cmd) {
+    if (len == 0) return false;
+    
+    uint8_t values[3];
+    
+    if (str[0] == '@') {
+        if (parseByteList(str + 1, len - 1, values, 1) != 1) return false;
+        if (values[0] >= LED_PALETTE_SIZE) return false;
+        cmd.paletteIndex = values[0];
+        return true;
+    }
+    
+    if (str[0] == 'H' || str[0] == 'h') {
+        values[1] = 255;
+        values[2] = 255;
+        if (parseByteList(str + 1, len - 1, values, 3) < 1) return false;
+        RgbColor color = LedController::hsvToRgb(values[0], values[1], values[2]);
+        cmd.r = color.r; cmd.g = color.g; cmd.b = color.b;
+        return true;
+    }
+    
+    if (parseByteList(str, len, values, 3) != 3) return false;
+    cmd.r = values[0]; cmd.g = values[1]; cmd.b = values[2];
+    return true;
+}
+
 const char* CommandController::actionToString(CommandAction action) {
     switch (action) {
         case CommandAction::SHOW: return "SHOW";
@@ -317,6 +878,27 @@ const char* CommandController::actionToString(CommandAction action) {
         case CommandAction::SEQUENCE_COMPLETED: return "SEQUENCE_COMPLETED";
         case CommandAction::INFO: return "INFO";
         case CommandAction::PING: return "PING";
+        case CommandAction::SELFTEST: return "SELFTEST";
+        case CommandAction::DISCOVER: return "DISCOVER";
+        case CommandAction::ASSIGN: return "ASSIGN";
+        case CommandAction::ASSIGN_TOUCH: return "ASSIGN_TOUCH";
+        case CommandAction::INJECT: return "INJECT";
+        case CommandAction::INJECT_RUN: return "INJECT_RUN";
+        case CommandAction::INJECT_STOP: return "INJECT_STOP";
+        case CommandAction::STATS: return "STATS";
+        case CommandAction::PALETTE: return "PALETTE";
+        case CommandAction::HUE_CYCLE: return "HUE_CYCLE";
+        case CommandAction::PATTERN: return "PATTERN";
+        case CommandAction::FRAME_SYNC: return "FRAME_SYNC";
+        case CommandAction::GET_FRAME: return "GET_FRAME";
+        case CommandAction::FRAME_HASH: return "FRAME_HASH";
+        case CommandAction::EXPAND_TO: return "EXPAND_TO";
+        case CommandAction::METER: return "METER";
+        case CommandAction::SCENE_STORE: return "SCENE_STORE";
+        case CommandAction::SCENE_RECALL: return "SCENE_RECALL";
+        case CommandAction::SEQ_PLAY: return "SEQ_PLAY";
+        case CommandAction::SEQ_VERIFY: return "SEQ_VERIFY";
+        case CommandAction::REACT: return "REACT";
         default: return "INVALID";
     }
 }
@@ -332,11 +914,18 @@ bool CommandController::actionRequiresPosition(CommandAction action) {
         case CommandAction::STOP_BLINK:
         case CommandAction::EXPAND_STEP:
         case CommandAction::CONTRACT_STEP:
+        case CommandAction::METER:
         case CommandAction::EXPECT:
         case CommandAction::EXPECT_RELEASE:
         case CommandAction::RECALIBRATE:
         case CommandAction::VALUE:
         case CommandAction::SET_SENSITIVITY:
+        case CommandAction::ASSIGN:
+        case CommandAction::ASSIGN_TOUCH:
+        case CommandAction::INJECT:
+        case CommandAction::HUE_CYCLE:
+        case CommandAction::EXPAND_TO:
+        case CommandAction::REACT:
             return true;
         default:
             return false;
@@ -349,39 +938,229 @@ bool CommandController::actionIsLongRunning(CommandAction action) {
         case CommandAction::CONTRACT:
         case CommandAction::SEQUENCE_COMPLETED:
         case CommandAction::MENUE_CHANGE:
+        case CommandAction::PATTERN:
+        case CommandAction::GET_FRAME:
+        case CommandAction::SELFTEST:
+        case CommandAction::INJECT_RUN:
+        case CommandAction::SEQ_PLAY:
+        case CommandAction::SEQ_VERIFY:
+        case CommandAction::REACT:
             return true;
         default:
             return false;
     }
 }
 
-// ============================================================================
-// Command Execution
-// ============================================================================
-
-void CommandController::executeCommand(const ParsedCommand& cmd) {
-    if (!cmd.valid) return;
-    
-    uint32_t cmdId = cmd.hasId ? cmd.id : COMMAND_ID_NONE;
+/**
+ * @brief Long-running check that also looks at arguments
+ * 
+ * EXPAND_TO only waits for DONE when it animates (ms given and non-zero).
+ * SHOW, FAIL and BLINK are queued when given a duration, to turn off on time.
+ */
+bool CommandController::isLongRunning(const ParsedCommand& cmd) {
+    if (cmd.action == CommandAction::EXPAND_TO) {
+        return cmd.argCount > 1 && cmd.args[1] > 0;
+    }
+    if (isTimedState(cmd)) return true;
+    return actionIsLongRunning(cmd.action);
+}
+
+/**
+ * @brief SHOW / FAIL / BLINK with a duration: turns itself off again
+ */
+bool CommandController::isTimedState(const ParsedCommand& cmd) {
+    return (cmd.action == CommandAction::SHOW || cmd.action == CommandAction::FAIL ||
+            cmd.action == CommandAction::BLINK) && cmd.argCount > 0;
+}
+
+// ============================================================================
+// Command Execution
+// ============================================================================
+
+void CommandController::executeCommand(const ParsedCommand& parsed) {
+    if (!parsed.valid) {
+        if (parsed.error) m_eventQueue.queueError(parsed.error, COMMAND_ID_NONE);
+        return;
+    }
+    
+    uint32_t cmdId = parsed.hasId ? parsed.id : COMMAND_ID_NONE;
+    
+    // Overload: keep the health check and the way out (HIDE_ALL) working
+    if (m_rejectNew && parsed.action != CommandAction::PING &&
+        parsed.action != CommandAction::INFO && parsed.action != CommandAction::HIDE_ALL) {
+        m_eventQueue.queueBusy(cmdId);
+        return;
+    }
+    
+    // Palette colors resolve here so a PALETTE earlier in the same burst applies
+    ParsedCommand cmd = parsed;
+    if (cmd.paletteIndex != PALETTE_INDEX_NONE) {
+        RgbColor color;
+        m_ledController.getPaletteColor(cmd.paletteIndex, color);
+        cmd.r = color.r; cmd.g = color.g; cmd.b = color.b;
+    }
+    
+    if ((cmd.action == CommandAction::SELFTEST || cmd.action == CommandAction::INJECT_RUN ||
+         cmd.action == CommandAction::SEQ_VERIFY || cmd.action == CommandAction::REACT) &&
+        !m_touchController) {
+        m_eventQueue.queueError("no_touch_controller", cmdId);
+        return;
+    }
+    
+    if (cmd.action == CommandAction::INJECT_RUN) {
+        // Check for a free slot first so a started script always gets its DONE.
+        // One script at a time, like the other single-instance commands.
+        if (isQueueFull() || !m_touchController->isInjectScriptComplete()) {
+            m_eventQueue.queueBusy(cmdId);
+            return;
+        }
+        
+        uint16_t holdMs = (cmd.argCount > 2) ? cmd.args[2] : INJECT_DEFAULT_HOLD_MS;
+        if (!m_touchController->startInjectScript(static_cast<InjectPattern>(cmd.extraValue),
+                                                  cmd.args[0], cmd.args[1], holdMs)) {
+            m_eventQueue.queueError("invalid_params", cmdId);
+            return;
+        }
+    }
+    
+    if (cmd.action == CommandAction::GET_FRAME) {
+        // One readback at a time; the snapshot buffer is shared
+        if (m_readbackActive || isQueueFull()) {
+            m_eventQueue.queueBusy(cmdId);
+            return;
+        }
+        if (!startReadback(cmd)) {
+            m_eventQueue.queueError("invalid_params", cmdId);
+            return;
+        }
+    }
+    
+    if (cmd.action == CommandAction::SEQ_VERIFY) {
+        // One run at a time; presses come from a single stream
+        if (m_seqVerifyActive || isQueueFull()) {
+            m_eventQueue.queueBusy(cmdId);
+            return;
+        }
+        for (uint8_t i = 0; i < cmd.stepCount; i++) {
+            if (!m_touchController->isSensorActive(cmd.steps[i])) {
+                m_eventQueue.queueError("sensor_inactive", cmdId);
+                return;
+            }
+        }
+        m_touchController->setEdgeListener(true);
+        m_seqVerifyActive = true;
+        m_seqVerifyMiss = 0;
+    }
+    
+    if (cmd.action == CommandAction::REACT) {
+        if (m_reactActive || isQueueFull()) {
+            m_eventQueue.queueBusy(cmdId);
+            return;
+        }
+        if (!m_touchController->isSensorActive(cmd.positionIndex)) {
+            m_eventQueue.queueError("sensor_inactive", cmdId);
+            return;
+        }
+        m_reactActive = true;
+    }
+    
+    if (cmd.action == CommandAction::EXPAND_TO &&
+        cmd.args[0] > m_ledController.getMaxRadius(cmd.positionIndex)) {
+        m_eventQueue.queueError("invalid_params", cmdId);
+        return;
+    }
     
-    if (actionIsLongRunning(cmd.action)) {
-        if (!queueCommand(cmd)) {
+    if (isLongRunning(cmd)) {
+        if (isQueueFull()) {
             // Use BUSY response for flow control (allows Pi to retry)
             m_eventQueue.queueBusy(cmdId);
             return;
         }
+        releaseTimedStates(cmd);
+        queueCommand(cmd);
     } else {
+        releaseTimedStates(cmd);
         executeInstant(cmd);
     }
 }
 
+/**
+ * @brief Ends timed SHOW / FAIL / BLINK on positions the new command takes over
+ * 
+ * The earlier command ends without turning the LED off (with its DONE if it
+ * asked for one), the way a SUCCESS cut short by HIDE completes.
+ */
+void CommandController::releaseTimedStates(const ParsedCommand& cmd) {
+    for (uint8_t i = 0; i < QUEUE_SIZE_COMMANDS; i++) {
+        QueuedCommand& qc = m_commandQueue[i];
+        if (!qc.active || qc.state != QUEUED_STATE_RUNNING || !isTimedState(qc.command)) continue;
+        if (!drawsOver(cmd, qc.command.positionIndex)) continue;
+        endTimedState(qc);
+    }
+}
+
+/**
+ * @brief Whether a command draws over a position
+ * 
+ * Whole-board commands take over every position, SEQ_PLAY its steps and
+ * METER the positions within its span.
+ */
+bool CommandController::drawsOver(const ParsedCommand& cmd, uint8_t positionIndex) const {
+    switch (cmd.action) {
+        case CommandAction::HIDE_ALL:
+        case CommandAction::SCENE_RECALL:
+        case CommandAction::SEQUENCE_COMPLETED:
+        case CommandAction::MENUE_CHANGE:
+        case CommandAction::PATTERN:
+            return true;
+            
+        case CommandAction::SEQ_PLAY:
+            for (uint8_t i = 0; i < cmd.stepCount; i++) {
+                if (cmd.steps[i] == positionIndex) return true;
+            }
+            return false;
+            
+        case CommandAction::METER:
+            return m_ledController.spanContains(cmd.positionIndex, cmd.extraValue, positionIndex);
+            
+        case CommandAction::SHOW:
+        case CommandAction::HIDE:
+        case CommandAction::SUCCESS:
+        case CommandAction::FAIL:
+        case CommandAction::CONTRACT:
+        case CommandAction::BLINK:
+        case CommandAction::STOP_BLINK:
+        case CommandAction::EXPAND_STEP:
+        case CommandAction::CONTRACT_STEP:
+        case CommandAction::EXPAND_TO:
+        case CommandAction::HUE_CYCLE:
+        case CommandAction::REACT:
+            return cmd.positionIndex == positionIndex;
+            
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Completes a timed SHOW / FAIL / BLINK; DONE only if it asked for one
+ */
+void CommandController::endTimedState(QueuedCommand& qc) {
+    if (qc.command.reportDone) {
+        finishLedCommand(qc);
+    } else {
+        qc.active = false;
+    }
+}
+
 void CommandController::executeInstant(const ParsedCommand& cmd) {
     uint32_t cmdId = cmd.hasId ? cmd.id : COMMAND_ID_NONE;
     const char* actionStr = actionToString(cmd.action);
     
     switch (cmd.action) {
         case CommandAction::SHOW:
-            if (m_ledController.show(cmd.positionIndex)) {
+            if (cmd.hasColor ? m_ledController.show(cmd.positionIndex, { cmd.r, cmd.g, cmd.b })
+                             : m_ledController.show(cmd.positionIndex)) {
                 m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
             } else {
                 m_eventQueue.queueError("command_failed", cmdId);
@@ -410,7 +1189,8 @@ void CommandController::executeInstant(const ParsedCommand& cmd) {
             break;
             
         case CommandAction::BLINK:
-            if (m_ledController.blink(cmd.positionIndex)) {
+            if (cmd.hasColor ? m_ledController.blink(cmd.positionIndex, { cmd.r, cmd.g, cmd.b })
+                             : m_ledController.blink(cmd.positionIndex)) {
                 m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
             } else {
                 m_eventQueue.queueError("command_failed", cmdId);
@@ -433,6 +1213,41 @@ void CommandController::executeInstant(const ParsedCommand& cmd) {
             }
             break;
             
+        case CommandAction::EXPAND_TO:
+            if (m_ledController.expandTo(cmd.positionIndex, cmd.args[0])) {
+                m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
+            } else {
+                m_eventQueue.queueError("command_failed", cmdId);
+            }
+            break;
+            
+        case CommandAction::METER:
+            if (cmd.hasColor ? m_ledController.setMeter(cmd.positionIndex, cmd.extraValue, cmd.args[0], { cmd.r, cmd.g, cmd.b })
+                             : m_ledController.setMeter(cmd.positionIndex, cmd.extraValue, cmd.args[0])) {
+                m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
+            } else {
+                m_eventQueue.queueError("invalid_params", cmdId);
+            }
+            break;
+            
+        case CommandAction::HUE_CYCLE: {
+            uint16_t periodMs = (cmd.argCount > 0) ? cmd.args[0] : LED_HUE_CYCLE_DEFAULT_MS;
+            if (m_ledController.hueCycle(cmd.positionIndex, periodMs)) {
+                m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
+            } else {
+                m_eventQueue.queueError("command_failed", cmdId);
+            }
+            break;
+        }
+            
+        case CommandAction::PALETTE:
+            if (m_ledController.setPaletteColor(cmd.extraValue, { cmd.r, cmd.g, cmd.b })) {
+                m_eventQueue.queueAck(actionStr, 0, cmdId);
+            } else {
+                m_eventQueue.queueError("command_failed", cmdId);
+            }
+            break;
+            
         case CommandAction::CONTRACT_STEP:
             if (m_ledController.contractStep(cmd.positionIndex)) {
                 m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
@@ -441,31 +1256,43 @@ void CommandController::executeInstant(const ParsedCommand& cmd) {
             }
             break;
             
+        // LEVEL is armed on the touch task, which sends the ACK once it takes the request
+        // up and before it may report the level; a timed-out one is cancelled unarmed
         case CommandAction::EXPECT:
-            if (m_touchController) {
-                m_touchController->setExpectDown(cmd.positionIndex, cmdId);
-                m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
-            } else {
+            if (!m_touchController) {
                 m_eventQueue.queueError("no_touch_controller", cmdId);
+            } else if (cmd.level) {
+                awaitSensorRequest(m_touchController->requestExpectLevel(cmd.positionIndex, true, cmdId,
+                                                                         static_cast<DebounceProfile>(cmd.extraValue)),
+                                   cmdId);
+            } else {
+                m_touchController->setExpectDown(cmd.positionIndex, cmdId,
+                                                 static_cast<DebounceProfile>(cmd.extraValue));
+                m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
             }
             break;
             
         case CommandAction::EXPECT_RELEASE:
-            if (m_touchController) {
-                m_touchController->setExpectUp(cmd.positionIndex, cmdId);
-                m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
-            } else {
+            if (!m_touchController) {
                 m_eventQueue.queueError("no_touch_controller", cmdId);
+            } else if (cmd.level) {
+                awaitSensorRequest(m_touchController->requestExpectLevel(cmd.positionIndex, false, cmdId,
+                                                                         static_cast<DebounceProfile>(cmd.extraValue)),
+                                   cmdId);
+            } else {
+                m_touchController->setExpectUp(cmd.positionIndex, cmdId,
+                                               static_cast<DebounceProfile>(cmd.extraValue));
+                m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
             }
             break;
             
+        // The touch task owns the bus: these are handed over and answered once done
         case CommandAction::RECALIBRATE:
             if (m_touchController) {
-                if (m_touchController->recalibrate(cmd.positionIndex)) {
-                    m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
-                    m_eventQueue.queueRecalibrated(cmd.position, cmdId);
-                } else {
+                if (!m_touchController->isSensorActive(cmd.positionIndex)) {
                     m_eventQueue.queueError("command_failed", cmdId);
+                } else {
+                    awaitSensorRequest(m_touchController->requestRecalibrate(cmd.positionIndex, cmdId), cmdId);
                 }
             } else {
                 m_eventQueue.queueError("no_touch_controller", cmdId);
@@ -474,9 +1301,7 @@ void CommandController::executeInstant(const ParsedCommand& cmd) {
             
         case CommandAction::RECALIBRATE_ALL:
             if (m_touchController) {
-                m_touchController->recalibrateAll();
-                m_eventQueue.queueAck(actionStr, 0, cmdId);
-                m_eventQueue.queueRecalibrated(0, cmdId);
+                awaitSensorRequest(m_touchController->requestRecalibrateAll(cmdId), cmdId);
             } else {
                 m_eventQueue.queueError("no_touch_controller", cmdId);
             }
@@ -484,10 +1309,11 @@ void CommandController::executeInstant(const ParsedCommand& cmd) {
             
         case CommandAction::SET_SENSITIVITY:
             if (m_touchController) {
-                if (m_touchController->setSensitivity(cmd.positionIndex, cmd.extraValue)) {
-                    m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
-                } else {
+                if (!m_touchController->isSensorActive(cmd.positionIndex)) {
                     m_eventQueue.queueError("command_failed", cmdId);
+                } else {
+                    awaitSensorRequest(m_touchController->requestSensitivity(cmd.positionIndex, cmd.extraValue,
+                                                                             cmdId), cmdId);
                 }
             } else {
                 m_eventQueue.queueError("no_touch_controller", cmdId);
@@ -506,17 +1332,124 @@ void CommandController::executeInstant(const ParsedCommand& cmd) {
             
         case CommandAction::VALUE:
             if (m_touchController) {
-                int8_t sensorValue;
-                if (m_touchController->readSensorValue(cmd.positionIndex, sensorValue)) {
-                    m_eventQueue.queueValue(cmd.position, sensorValue, cmdId);
+                if (!m_touchController->isSensorActive(cmd.positionIndex)) {
+                    m_eventQueue.queueError("sensor_inactive", cmdId);
+                } else {
+                    awaitSensorRequest(m_touchController->requestValue(cmd.positionIndex, cmdId), cmdId);
+                }
+            } else {
+                m_eventQueue.queueError("no_touch_controller", cmdId);
+            }
+            break;
+            
+        case CommandAction::DISCOVER:
+            if (m_touchController) {
+                if (m_touchController->requestDiscover(cmdId)) {
+                    m_eventQueue.queueAck(actionStr, 0, cmdId);
+                } else {
+                    m_eventQueue.queueBusy(cmdId);
+                }
+            } else {
+                m_eventQueue.queueError("no_touch_controller", cmdId);
+            }
+            break;
+            
+        case CommandAction::ASSIGN:
+            if (m_touchController) {
+                if (m_touchController->requestAssign(cmd.extraValue, cmd.positionIndex, cmdId)) {
+                    m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
                 } else {
+                    m_eventQueue.queueBusy(cmdId);
+                }
+            } else {
+                m_eventQueue.queueError("no_touch_controller", cmdId);
+            }
+            break;
+            
+        case CommandAction::ASSIGN_TOUCH:
+            if (m_touchController) {
+                if (m_touchController->requestAssignByTouch(cmd.positionIndex, cmdId)) {
+                    m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
+                } else {
+                    m_eventQueue.queueBusy(cmdId);
+                }
+            } else {
+                m_eventQueue.queueError("no_touch_controller", cmdId);
+            }
+            break;
+            
+        case CommandAction::INJECT:
+            if (m_touchController) {
+                uint16_t delayMs = (cmd.argCount > 0) ? cmd.args[0] : 0;
+                if (!m_touchController->isSensorActive(cmd.positionIndex)) {
                     m_eventQueue.queueError("sensor_inactive", cmdId);
+                } else if (m_touchController->injectTouch(cmd.positionIndex, cmd.extraValue != 0, delayMs)) {
+                    m_eventQueue.queueAck(actionStr, cmd.position, cmdId);
+                } else {
+                    m_eventQueue.queueBusy(cmdId);
                 }
             } else {
                 m_eventQueue.queueError("no_touch_controller", cmdId);
             }
             break;
             
+        case CommandAction::INJECT_STOP:
+            if (m_touchController) {
+                m_touchController->stopInjectScript();
+                m_eventQueue.queueAck(actionStr, 0, cmdId);
+            } else {
+                m_eventQueue.queueError("no_touch_controller", cmdId);
+            }
+            break;
+            
+        case CommandAction::STATS:
+            if (m_touchController) {
+                TouchStats stats = m_touchController->getStats();
+                char report[52];
+                snprintf(report, sizeof(report), "down=%lu up=%lu synthetic=%lu suppressed=%lu",
+                         stats.touched, stats.released, stats.synthetic, stats.suppressed);
+                m_eventQueue.queueStats(report, cmdId);
+            } else {
+                m_eventQueue.queueError("no_touch_controller", cmdId);
+            }
+            break;
+            
+        case CommandAction::FRAME_SYNC:
+            m_frameSyncEvery = cmd.args[0];
+            m_lastSyncedFrame = m_ledController.getFrameCount();
+            m_eventQueue.queueAck(actionStr, 0, cmdId);
+            break;
+            
+        case CommandAction::FRAME_HASH: {
+            uint32_t frame = m_ledController.getFrameCount();
+            for (uint8_t strip = 1; strip <= 2; strip++) {
+                if (cmd.argCount > 0 && cmd.args[0] != strip) continue;
+                StripId id = (strip == 1) ? StripId::STRIP1 : StripId::STRIP2;
+                m_eventQueue.queueFrameHash(strip, m_ledController.frameHash(id), frame, cmdId);
+            }
+            break;
+        }
+            
+        case CommandAction::SCENE_STORE:
+            m_ledController.storeScene(cmd.args[0]);
+            if (m_touchController) {
+                m_touchController->storeExpectations(cmd.args[0]);
+            }
+            m_eventQueue.queueAck(actionStr, 0, cmdId);
+            break;
+            
+        // Expectations from the scene are re-armed under this command's ID
+        case CommandAction::SCENE_RECALL:
+            if (!m_ledController.recallScene(cmd.args[0])) {
+                m_eventQueue.queueError("scene_empty", cmdId);
+                break;
+            }
+            if (m_touchController) {
+                m_touchController->recallExpectations(cmd.args[0], cmdId);
+            }
+            m_eventQueue.queueAck(actionStr, 0, cmdId);
+            break;
+            
         case CommandAction::INFO:
             m_eventQueue.queueInfo(cmdId);
             break;
@@ -538,7 +1471,9 @@ bool CommandController::queueCommand(const ParsedCommand& cmd) {
             m_commandQueue[i].command = cmd;
             m_commandQueue[i].active = true;
             m_commandQueue[i].startTime = millis();
-            m_commandQueue[i].state = 0;
+            m_commandQueue[i].state = QUEUED_STATE_RUNNING;
+            m_commandQueue[i].step = 0;
+            m_commandQueue[i].stepTime = m_commandQueue[i].startTime;
             
             // Send ACK immediately
             uint32_t cmdId = cmd.hasId ? cmd.id : COMMAND_ID_NONE;
@@ -546,13 +1481,41 @@ bool CommandController::queueCommand(const ParsedCommand& cmd) {
             
             // Start the action
             if (cmd.action == CommandAction::SUCCESS) {
-                m_ledController.success(cmd.positionIndex);
+                if (cmd.hasColor) {
+                    m_ledController.success(cmd.positionIndex, { cmd.r, cmd.g, cmd.b });
+                } else {
+                    m_ledController.success(cmd.positionIndex);
+                }
             } else if (cmd.action == CommandAction::CONTRACT) {
                 m_ledController.contract(cmd.positionIndex);
             } else if (cmd.action == CommandAction::SEQUENCE_COMPLETED) {
                 m_ledController.startSequenceCompletedAnimation();
             } else if (cmd.action == CommandAction::MENUE_CHANGE) {
                 m_ledController.startMenuChangeAnimation(cmd.r, cmd.g, cmd.b, cmd.range);
+            } else if (cmd.action == CommandAction::EXPAND_TO) {
+                m_ledController.expandTo(cmd.positionIndex, cmd.args[0], cmd.args[1]);
+            } else if (cmd.action == CommandAction::PATTERN) {
+                m_ledController.startPattern(cmd.args[0]);
+            } else if (cmd.action == CommandAction::SELFTEST) {
+                m_touchController->startSelfTest();
+            } else if (cmd.action == CommandAction::SHOW) {
+                if (cmd.hasColor) {
+                    m_ledController.show(cmd.positionIndex, { cmd.r, cmd.g, cmd.b });
+                } else {
+                    m_ledController.show(cmd.positionIndex);
+                }
+            } else if (cmd.action == CommandAction::FAIL) {
+                m_ledController.fail(cmd.positionIndex);
+            } else if (cmd.action == CommandAction::BLINK) {
+                if (cmd.hasColor) {
+                    m_ledController.blink(cmd.positionIndex, { cmd.r, cmd.g, cmd.b });
+                } else {
+                    m_ledController.blink(cmd.positionIndex);
+                }
+            } else if (cmd.action == CommandAction::REACT) {
+                m_ledController.show(cmd.positionIndex);
+                m_touchController->armReaction(cmd.positionIndex);
+                m_commandQueue[i].doneFrame = m_ledController.getPendingFrame();
             }
             
             return true;
@@ -564,45 +1527,492 @@ bool CommandController::queueCommand(const ParsedCommand& cmd) {
 void CommandController::tickCommand(QueuedCommand& qc) {
     if (!qc.active) return;
     
+    if (qc.state == QUEUED_STATE_FRAME_WAIT) {
+        tickLedDone(qc);
+        return;
+    }
+    
     uint32_t cmdId = qc.command.hasId ? qc.command.id : COMMAND_ID_NONE;
     
     switch (qc.command.action) {
         case CommandAction::SUCCESS:
             if (m_ledController.isAnimationComplete(qc.command.positionIndex)) {
-                m_eventQueue.queueDone(actionToString(qc.command.action), 
-                                       qc.command.position, cmdId);
-                qc.active = false;
+                finishLedCommand(qc);
             }
             break;
             
         case CommandAction::CONTRACT:
             if (m_ledController.isContractComplete(qc.command.positionIndex)) {
-                m_eventQueue.queueDone(actionToString(qc.command.action), 
-                                       qc.command.position, cmdId);
-                qc.active = false;
+                finishLedCommand(qc);
+            }
+            break;
+            
+        case CommandAction::EXPAND_TO:
+            if (m_ledController.isExpandComplete(qc.command.positionIndex)) {
+                finishLedCommand(qc);
             }
             break;
             
         case CommandAction::SEQUENCE_COMPLETED:
             if (m_ledController.isSequenceCompletedAnimationComplete()) {
-                m_eventQueue.queueDone(actionToString(qc.command.action), 0, cmdId);
-                qc.active = false;
+                finishLedCommand(qc);
             }
             break;
             
         case CommandAction::MENUE_CHANGE:
             if (m_ledController.isMenuChangeAnimationComplete()) {
+                finishLedCommand(qc);
+            }
+            break;
+            
+        case CommandAction::PATTERN:
+            if (m_ledController.isPatternComplete()) {
+                finishLedCommand(qc);
+            }
+            break;
+            
+        // Timed SHOW / FAIL / BLINK (only queued with a duration)
+        case CommandAction::SHOW:
+        case CommandAction::FAIL:
+        case CommandAction::BLINK:
+            if (millis() - qc.startTime >= qc.command.args[0]) {
+                m_ledController.hide(qc.command.positionIndex);
+                endTimedState(qc);
+            }
+            break;
+            
+        case CommandAction::SEQ_PLAY:
+            if (tickSeqPlay(qc)) {
+                finishLedCommand(qc);
+            }
+            break;
+            
+        case CommandAction::SEQ_VERIFY:
+            if (tickSeqVerify(qc)) {
+                m_touchController->setEdgeListener(false);
+                m_seqVerifyActive = false;
+                reportSeqVerify(qc, cmdId);
+                qc.active = false;
+            }
+            break;
+            
+        case CommandAction::REACT:
+            if (tickReact(qc, cmdId)) {
+                m_reactActive = false;
+                qc.active = false;
+            }
+            break;
+            
+        case CommandAction::GET_FRAME:
+            if (tickReadback(cmdId)) {
                 m_eventQueue.queueDone(actionToString(qc.command.action), 0, cmdId);
                 qc.active = false;
             }
             break;
             
+        case CommandAction::INJECT_RUN:
+            if (m_touchController->isInjectScriptComplete()) {
+                if (m_touchController->didInjectScriptOverflow()) {
+                    m_eventQueue.queueError("inject_overflow", cmdId);
+                } else {
+                    m_eventQueue.queueDone(actionToString(qc.command.action), 0, cmdId);
+                }
+                qc.active = false;
+            }
+            break;
+            
+        case CommandAction::SELFTEST:
+            if (m_touchController->isSelfTestComplete()) {
+                reportSelfTest(cmdId);
+                qc.active = false;
+            }
+            break;
+            
         default:
             qc.active = false;
             break;
     }
 }
 
+/**
+ * @brief Lights and darkens SEQ_PLAY positions on a fixed schedule
+ * 
+ * Step i lights at i * (on_ms + gap_ms) after the start and goes dark
+ * on_ms later. Times count from the start, not from the previous switch,
+ * so a late loop pass does not shift the steps after it.
+ * 
+ * @return true once the last position is dark
+ */
+bool CommandController::tickSeqPlay(QueuedCommand& qc) {
+    const ParsedCommand& cmd = qc.command;
+    uint32_t onMs = cmd.args[0];
+    uint32_t period = onMs + cmd.args[1];
+    uint32_t elapsed = millis() - qc.startTime;
+    
+    // qc.step counts switches: even lights step / 2, odd darkens it
+    while (qc.step < cmd.stepCount * 2) {
+        uint8_t index = qc.step / 2;
+        bool off = qc.step & 1;
+        if (elapsed < index * period + (off ? onMs : 0)) return false;
+        
+        if (off) {
+            m_ledController.hide(cmd.steps[index]);
+        } else {
+            m_ledController.show(cmd.steps[index]);
+        }
+        qc.step++;
+    }
+    return true;
+}
+
+/**
+ * @brief Scores SEQ_VERIFY presses handed over by the touch task
+ * 
+ * Reaction time runs from the previous correct press (from the start for
+ * the first step) and uses raw press edges, so debounce is not counted.
+ * The first wrong press or timeout ends the run.
+ * 
+ * @return true when the run is over; qc.step is then the number of correct steps
+ */
+bool CommandController::tickSeqVerify(QueuedCommand& qc) {
+    const ParsedCommand& cmd = qc.command;
+    TouchEdge edge;
+    
+    while (m_touchController->takeTouchEdge(edge)) {
+        uint8_t expected = cmd.steps[qc.step];
+        int32_t reaction = (int32_t)(edge.time - qc.stepTime);
+        if (reaction < 0) reaction = 0;  // Press began before the step did
+        
+        m_seqVerifyMs[qc.step] = (uint16_t)min<int32_t>(reaction, UINT16_MAX);
+        if (edge.sensorIndex != expected) {
+            m_seqVerifyMiss = 'A' + edge.sensorIndex;
+            return true;
+        }
+        
+        qc.stepTime += reaction;
+        if (++qc.step >= cmd.stepCount) return true;
+    }
+    
+    uint32_t waited = millis() - qc.stepTime;
+    if (waited >= cmd.args[0]) {
+        m_seqVerifyMs[qc.step] = (uint16_t)min<uint32_t>(waited, UINT16_MAX);
+        m_seqVerifyMiss = '-';
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Sends the result of a SEQ_VERIFY run as one DONE line
+ * 
+ * "score=<n>/<total> pass=<hex> [wrong=<pos>|timeout] ms=<a>,<b>,..." with
+ * bit i of pass set when step i was correct, and one reaction time per
+ * step reached. Times that do not fit on the DONE line go ahead of it in
+ * SEQ_TIMES chunks instead, and DONE then carries no ms=.
+ */
+void CommandController::reportSeqVerify(const QueuedCommand& qc, uint32_t cmdId) {
+    uint8_t reached = qc.step + (m_seqVerifyMiss ? 1 : 0);
+    uint32_t passMask = (1UL << qc.step) - 1;  // The first failure ends the run
+    
+    char detail[sizeof(Event::extra)];
+    int length = snprintf(detail, sizeof(detail), "score=%u/%u pass=%lX",
+                          qc.step, qc.command.stepCount, passMask);
+    if (m_seqVerifyMiss == '-') {
+        length += snprintf(detail + length, sizeof(detail) - length, " timeout");
+    } else if (m_seqVerifyMiss) {
+        length += snprintf(detail + length, sizeof(detail) - length, " wrong=%c", m_seqVerifyMiss);
+    }
+    
+    char times[SEQ_MAX_STEPS * 6 + 1];
+    size_t timesLength = 0;
+    times[0] = '\0';
+    for (uint8_t i = 0; i < reached; i++) {
+        timesLength += snprintf(times + timesLength, sizeof(times) - timesLength,
+                                (i == 0) ? "%u" : ",%u", m_seqVerifyMs[i]);
+    }
+    
+    if (length + 4 + timesLength < sizeof(detail)) {
+        snprintf(detail + length, sizeof(detail) - length, " ms=%s", times);
+    } else {
+        // Chunks of whole values, each small enough for one event
+        char chunk[SEQ_TIMES_CHUNK_LENGTH];
+        uint8_t from = 0;
+        while (from < reached) {
+            size_t chunkLength = 0;
+            uint8_t i = from;
+            while (i < reached && chunkLength + 6 < sizeof(chunk)) {
+                chunkLength += snprintf(chunk + chunkLength, sizeof(chunk) - chunkLength,
+                                        (i == from) ? "%u" : ",%u", m_seqVerifyMs[i]);
+                i++;
+            }
+            m_eventQueue.queueSeqTimes(from, chunk, cmdId);
+            from = i;
+        }
+    }
+    
+    m_eventQueue.queueDone(actionToString(qc.command.action), 0, cmdId, detail);
+}
+
+/**
+ * @brief Starts the reaction probe when the lit frame is shown, then waits for the press
+ * 
+ * The start instant is the show() of doneFrame itself, as recorded by the
+ * output stage, even if a later frame was shown before this pass saw it.
+ * A press between the show and this pass still counts: the probe compares
+ * raw edge times.
+ * 
+ * @return true once REACT or the timeout error has been queued
+ */
+bool CommandController::tickReact(QueuedCommand& qc, uint32_t cmdId) {
+    if (qc.step == 0) {
+        if ((int32_t)(m_ledController.getFrameCount() - qc.doneFrame) < 0) return false;
+        
+        FrameTime shown;
+        if (!m_ledController.getFrameTime(qc.doneFrame, shown)) {
+            // Lost after a long stall: no trustworthy start instant
+            m_touchController->disarmReaction();
+            m_eventQueue.queueError("command_failed", cmdId);
+            return true;
+        }
+        m_touchController->startReaction(shown.shownMicros);
+        qc.stepTime = millis();
+        qc.step = 1;
+    }
+    
+    uint32_t reactionUs;
+    if (m_touchController->takeReaction(reactionUs)) {
+        m_eventQueue.queueReact(qc.command.position, reactionUs, cmdId);
+        return true;
+    }
+    
+    uint16_t timeoutMs = (qc.command.argCount > 0) ? qc.command.args[0] : REACT_DEFAULT_TIMEOUT_MS;
+    if (millis() - qc.stepTime < timeoutMs) return false;
+    
+    // A press may have landed between the check above and disarming
+    m_touchController->disarmReaction();
+    if (m_touchController->takeReaction(reactionUs)) {
+        m_eventQueue.queueReact(qc.command.position, reactionUs, cmdId);
+    } else {
+        m_eventQueue.queueError("react_timeout", cmdId);
+    }
+    return true;
+}
+
+/**
+ * @brief Called when an LED animation reaches its end state
+ * 
+ * The end state may still be composing, or be handed to the output stage
+ * but not yet shown. DONE waits for the frame that shows it.
+ */
+void CommandController::finishLedCommand(QueuedCommand& qc) {
+    qc.state = QUEUED_STATE_FRAME_WAIT;
+    qc.doneFrame = m_ledController.getPendingFrame();
+    tickLedDone(qc);
+}
+
+void CommandController::tickLedDone(QueuedCommand& qc) {
+    if ((int32_t)(m_ledController.getFrameCount() - qc.doneFrame) >= 0) {
+        queueLedDone(qc, qc.command.position);
+        qc.active = false;
+    }
+}
+
+/**
+ * @brief Sends DONE for an LED animation
+ * 
+ * Sent from tickLedDone() in the first pass that sees doneFrame shown. The
+ * output stage may have shown a later frame by then, so t= is looked up by
+ * frame number rather than taken from the last frame.
+ */
+void CommandController::queueLedDone(const QueuedCommand& qc, char position) {
+    uint32_t cmdId = qc.command.hasId ? qc.command.id : COMMAND_ID_NONE;
+    const char* actionStr = actionToString(qc.command.action);
+    
+    if (LED_REPORT_DONE_FRAME) {
+        FrameTime shown;
+        if (!m_ledController.getFrameTime(qc.doneFrame, shown)) {
+            // Only after a stall longer than LED_FRAME_TIME_HISTORY frames
+            shown.shownMillis = m_ledController.getLastFrameTime();
+        }
+        m_eventQueue.queueDone(actionStr, position, cmdId, qc.doneFrame, shown.shownMillis);
+    } else {
+        m_eventQueue.queueDone(actionStr, position, cmdId);
+    }
+}
+
+/**
+ * @brief Emits FRAME <n> t=<ms> for every n-th frame shown since the last call
+ * 
+ * The output stage can show two frames between passes, so every frame
+ * since the last call is checked and timed by its own number.
+ */
+void CommandController::tickFrameSync() {
+    uint32_t frame = m_ledController.getFrameCount();
+    
+    while (m_lastSyncedFrame != frame) {
+        m_lastSyncedFrame++;
+        if (m_lastSyncedFrame % m_frameSyncEvery != 0) continue;
+        
+        FrameTime shown;
+        if (m_ledController.getFrameTime(m_lastSyncedFrame, shown)) {
+            m_eventQueue.queueFrame(m_lastSyncedFrame, shown.shownMillis);
+        }
+    }
+}
+
+/**
+ * @brief Snapshots both logical framebuffers and sets up the range to stream
+ * 
+ * No strip argument streams both strips in full; with a strip, from and
+ * count select a pixel range (count defaults to the rest of the strip).
+ */
+bool CommandController::startReadback(const ParsedCommand& cmd) {
+    uint16_t length1 = m_ledController.getStripLength(StripId::STRIP1);
+    uint16_t length2 = m_ledController.getStripLength(StripId::STRIP2);
+    
+    if (cmd.argCount == 0) {
+        m_readbackStrip = 1;
+        m_readbackLastStrip = 2;
+        m_readbackNext = 0;
+        m_readbackEnd = length1;
+        m_readbackLastEnd = length2;
+    } else {
+        uint16_t length = (cmd.args[0] == 1) ? length1 : length2;
+        uint16_t from = (cmd.argCount > 1) ? cmd.args[1] : 0;
+        if (from >= length) return false;
+        
+        uint16_t count = (cmd.argCount > 2) ? cmd.args[2] : length - from;
+        if (count == 0 || count > length - from) return false;
+        
+        m_readbackStrip = cmd.args[0];
+        m_readbackLastStrip = cmd.args[0];
+        m_readbackNext = from;
+        m_readbackEnd = from + count;
+        m_readbackLastEnd = m_readbackEnd;
+    }
+    
+    m_ledController.readPixels(StripId::STRIP1, 0, length1, m_frameSnapshot);
+    m_ledController.readPixels(StripId::STRIP2, 0, length2, m_frameSnapshot + length1 * 3);
+    m_readbackActive = true;
+    return true;
+}
+
+/**
+ * @brief Queues the next PIXELS chunks of a running readback
+ * 
+ * Each chunk is "<strip> <from> <runs>" where runs are comma-separated
+ * RRGGBB hex colors, with *n appended for n repeats. Streaming pauses while
+ * the event queue is nearly full.
+ * 
+ * @return true once the whole range has been queued
+ */
+bool CommandController::tickReadback(uint32_t cmdId) {
+    uint16_t length1 = m_ledController.getStripLength(StripId::STRIP1);
+    
+    for (uint8_t chunk = 0; chunk < GET_FRAME_CHUNKS_PER_TICK; chunk++) {
+        if (m_readbackNext >= m_readbackEnd) {
+            if (m_readbackStrip >= m_readbackLastStrip) {
+                m_readbackActive = false;
+                return true;
+            }
+            m_readbackStrip++;
+            m_readbackNext = 0;
+            m_readbackEnd = m_readbackLastEnd;
+        }
+        
+        if (m_eventQueue.count() >= QUEUE_SIZE_EVENTS - GET_FRAME_QUEUE_HEADROOM) return false;
+        
+        const uint8_t* pixels = m_frameSnapshot + ((m_readbackStrip == 1) ? 0 : length1 * 3);
+        uint16_t chunkStart = m_readbackNext;
+        char runs[44];
+        size_t length = 0;
+        runs[0] = '\0';
+        
+        while (m_readbackNext < m_readbackEnd) {
+            const uint8_t* px = pixels + m_readbackNext * 3;
+            uint16_t run = 1;
+            while (m_readbackNext + run < m_readbackEnd && memcmp(px, px + run * 3, 3) == 0) {
+                run++;
+            }
+            
+            char token[12];
+            int tokenLength = (run > 1)
+                ? snprintf(token, sizeof(token), "%02X%02X%02X*%u", px[0], px[1], px[2], run)
+                : snprintf(token, sizeof(token), "%02X%02X%02X", px[0], px[1], px[2]);
+            
+            size_t needed = tokenLength + (length > 0 ? 1 : 0);
+            if (length + needed >= sizeof(runs)) break;
+            
+            if (length > 0) runs[length++] = ',';
+            memcpy(runs + length, token, tokenLength + 1);
+            length += tokenLength;
+            m_readbackNext += run;
+        }
+        
+        m_eventQueue.queuePixels(m_readbackStrip, chunkStart, runs, cmdId);
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Sends the per-sensor self-test reports, then DONE with the failing sensors
+ * 
+ * Each sensor packs into "<pos><i2c_avg_us>/<mean>/<var>/<recal_ms|->", and
+ * as many reports as fit share one SELFTEST line, so 25 sensors take a
+ * handful of lines. DONE carries "fail=<hex>", bit i set for 'A' + i.
+ */
+void CommandController::reportSelfTest(uint32_t cmdId) {
+    uint32_t failMask = 0;
+    char line[sizeof(Event::extra)];
+    size_t lineLength = 0;
+    
+    for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+        SelfTestResult result;
+        if (!m_touchController->getSelfTestResult(i, result)) continue;
+        
+        uint16_t transactions = result.samples + result.errors;
+        uint32_t i2cAvgUs = transactions ? result.i2cTotalUs / transactions : 0;
+        
+        float mean = 0.0f;
+        float variance = 0.0f;
+        if (result.samples > 0) {
+            mean = (float)result.deltaSum / result.samples;
+            variance = (float)result.deltaSumSq / result.samples - mean * mean;
+        }
+        
+        if (result.samples == 0 || result.errors > 0 || result.recalTimeMs < 0 ||
+            variance > SELFTEST_MAX_VARIANCE || i2cAvgUs > SELFTEST_MAX_I2C_US) {
+            failMask |= 1UL << i;
+        }
+        
+        char report[32];
+        int length = snprintf(report, sizeof(report), "%c%lu/%.1f/%.1f/",
+                              TouchController::indexToLetter(i), i2cAvgUs, mean, variance);
+        if (result.recalTimeMs >= 0) {
+            snprintf(report + length, sizeof(report) - length, "%ld", result.recalTimeMs);
+        } else {
+            snprintf(report + length, sizeof(report) - length, "-");
+        }
+        
+        // Start a new line when this report would not fit behind the last one
+        size_t reportLength = strlen(report);
+        if (lineLength > 0 && lineLength + 1 + reportLength >= sizeof(line)) {
+            m_eventQueue.queueSelfTest(line, cmdId);
+            lineLength = 0;
+        }
+        lineLength += snprintf(line + lineLength, sizeof(line) - lineLength,
+                               (lineLength == 0) ? "%s" : " %s", report);
+    }
+    if (lineLength > 0) {
+        m_eventQueue.queueSelfTest(line, cmdId);
+    }
+    
+    char detail[16];
+    snprintf(detail, sizeof(detail), "fail=%lX", failMask);
+    m_eventQueue.queueDone(actionToString(CommandAction::SELFTEST), 0, cmdId, detail);
+}
+
 // ============================================================================
 // Utility Methods
 // ============================================================================
@@ -17,6 +17,8 @@ EventQueue::EventQueue()
     : m_head(0)
     , m_tail(0)
     , m_count(0)
+    , m_readbackCount(0)
+    , m_coalesceAcks(false)
     , m_queueMutex(nullptr)
     , m_serialMutex(nullptr)
 {
@@ -41,6 +43,8 @@ void EventQueue::begin() {
     m_head = 0;
     m_tail = 0;
     m_count = 0;
+    m_readbackCount = 0;
+    m_coalesceAcks = false;
     
     for (uint8_t i = 0; i < QUEUE_SIZE_EVENTS; i++) {
         m_events[i].valid = false;
@@ -71,6 +75,9 @@ void EventQueue::flush(uint8_t maxEvents) {
                 m_events[m_tail].valid = false;
                 m_tail = (m_tail + 1) % QUEUE_SIZE_EVENTS;
                 m_count--;
+                if (event.type == EventType::PIXELS) {
+                    m_readbackCount--;
+                }
                 eventRetrieved = true;
             }
             xSemaphoreGive(m_queueMutex);
@@ -97,11 +104,23 @@ uint8_t EventQueue::count() const {
     return m_count;
 }
 
+uint8_t EventQueue::readbackCount() const {
+    return m_readbackCount;
+}
+
+void EventQueue::setCoalesceAcks(bool enabled) {
+    m_coalesceAcks = enabled;
+}
+
 // ============================================================================
 // Event Queueing Methods
 // ============================================================================
 
 bool EventQueue::queueAck(const char* action, char position, uint32_t commandId) {
+    if (m_coalesceAcks && commandId == COMMAND_ID_NONE && coalesceAck(action, position)) {
+        return true;
+    }
+    
     Event event;
     event.type = EventType::ACK;
     strncpy(event.action, action, sizeof(event.action) - 1);
@@ -125,6 +144,32 @@ bool EventQueue::queueDone(const char* action, char position, uint32_t commandId
     return enqueue(event);
 }
 
+bool EventQueue::queueDone(const char* action, char position, uint32_t commandId,
+                           uint32_t frame, uint32_t frameTimeMs) {
+    Event event;
+    event.type = EventType::DONE;
+    strncpy(event.action, action, sizeof(event.action) - 1);
+    event.action[sizeof(event.action) - 1] = '\0';
+    event.position = position;
+    event.commandId = commandId;
+    snprintf(event.extra, sizeof(event.extra), "frame=%lu t=%lu", frame, frameTimeMs);
+    event.valid = true;
+    return enqueue(event);
+}
+
+bool EventQueue::queueDone(const char* action, char position, uint32_t commandId, const char* detail) {
+    Event event;
+    event.type = EventType::DONE;
+    strncpy(event.action, action, sizeof(event.action) - 1);
+    event.action[sizeof(event.action) - 1] = '\0';
+    event.position = position;
+    event.commandId = commandId;
+    strncpy(event.extra, detail, sizeof(event.extra) - 1);
+    event.extra[sizeof(event.extra) - 1] = '\0';
+    event.valid = true;
+    return enqueue(event);
+}
+
 bool EventQueue::queueError(const char* reason, uint32_t commandId) {
     Event event;
     event.type = EventType::ERR;
@@ -170,6 +215,28 @@ bool EventQueue::queueTouchReleased(char position, uint32_t commandId) {
     return enqueue(event);
 }
 
+bool EventQueue::queueTouched(char position, uint32_t commandId, int8_t peakDelta) {
+    Event event;
+    event.type = EventType::TOUCHED;
+    event.action[0] = '\0';
+    event.position = position;
+    event.commandId = commandId;
+    snprintf(event.extra, sizeof(event.extra), "peak=%d", peakDelta);
+    event.valid = true;
+    return enqueue(event);
+}
+
+bool EventQueue::queueTouchReleased(char position, uint32_t commandId, int8_t peakDelta, uint32_t durationMs) {
+    Event event;
+    event.type = EventType::TOUCH_RELEASED;
+    event.action[0] = '\0';
+    event.position = position;
+    event.commandId = commandId;
+    snprintf(event.extra, sizeof(event.extra), "peak=%d ms=%lu", peakDelta, durationMs);
+    event.valid = true;
+    return enqueue(event);
+}
+
 bool EventQueue::queueScanned(const char* sensorList, uint32_t commandId) {
     Event event;
     event.type = EventType::SCANNED;
@@ -215,10 +282,187 @@ bool EventQueue::queueValue(char position, int8_t value, uint32_t commandId) {
     return enqueue(event);
 }
 
+/**
+ * @brief Queues "SELFTEST <report> <report> ...", packed per-sensor reports
+ */
+bool EventQueue::queueSelfTest(const char* reports, uint32_t commandId) {
+    Event event;
+    event.type = EventType::SELFTEST;
+    event.action[0] = '\0';
+    event.position = 0;
+    event.commandId = commandId;
+    strncpy(event.extra, reports, sizeof(event.extra) - 1);
+    event.extra[sizeof(event.extra) - 1] = '\0';
+    event.valid = true;
+    return enqueue(event);
+}
+
+bool EventQueue::queuePower(const char* mode, uint32_t wakeLatencyUs) {
+    Event event;
+    event.type = EventType::POWER;
+    strncpy(event.action, mode, sizeof(event.action) - 1);
+    event.action[sizeof(event.action) - 1] = '\0';
+    event.position = 0;
+    event.commandId = COMMAND_ID_NONE;
+    if (wakeLatencyUs > 0) {
+        snprintf(event.extra, sizeof(event.extra), "wake_us=%lu", wakeLatencyUs);
+    } else {
+        event.extra[0] = '\0';
+    }
+    event.valid = true;
+    return enqueue(event);
+}
+
+bool EventQueue::queueAssigned(char position, uint8_t address, uint32_t commandId) {
+    Event event;
+    event.type = EventType::ASSIGNED;
+    event.action[0] = '\0';
+    event.position = position;
+    event.commandId = commandId;
+    snprintf(event.extra, sizeof(event.extra), "0x%02X", address);
+    event.valid = true;
+    return enqueue(event);
+}
+
+/**
+ * @brief Queues "DISCOVERED <n> [<addrs>]", with a trailing "+" if more addresses follow
+ */
+bool EventQueue::queueDiscovered(uint8_t count, const char* unassignedList, bool more, uint32_t commandId) {
+    Event event;
+    event.type = EventType::DISCOVERED;
+    event.action[0] = '\0';
+    event.position = 0;
+    event.commandId = commandId;
+    snprintf(event.extra, sizeof(event.extra), "%u [%s]%s", count, unassignedList, more ? " +" : "");
+    event.valid = true;
+    return enqueue(event);
+}
+
+bool EventQueue::queueStats(const char* report, uint32_t commandId) {
+    Event event;
+    event.type = EventType::STATS;
+    event.action[0] = '\0';
+    event.position = 0;
+    event.commandId = commandId;
+    strncpy(event.extra, report, sizeof(event.extra) - 1);
+    event.extra[sizeof(event.extra) - 1] = '\0';
+    event.valid = true;
+    return enqueue(event);
+}
+
+bool EventQueue::queueFrame(uint32_t frame, uint32_t frameTimeMs) {
+    Event event;
+    event.type = EventType::FRAME;
+    event.action[0] = '\0';
+    event.position = 0;
+    event.commandId = COMMAND_ID_NONE;
+    snprintf(event.extra, sizeof(event.extra), "%lu t=%lu", frame, frameTimeMs);
+    event.valid = true;
+    return enqueue(event);
+}
+
+bool EventQueue::queuePixels(uint8_t strip, uint16_t from, const char* runs, uint32_t commandId) {
+    Event event;
+    event.type = EventType::PIXELS;
+    event.action[0] = '\0';
+    event.position = 0;
+    event.commandId = commandId;
+    snprintf(event.extra, sizeof(event.extra), "%u %u %s", strip, from, runs);
+    event.valid = true;
+    return enqueue(event);
+}
+
+bool EventQueue::queueFrameHash(uint8_t strip, uint32_t hash, uint32_t frame, uint32_t commandId) {
+    Event event;
+    event.type = EventType::FRAME_HASH;
+    event.action[0] = '\0';
+    event.position = 0;
+    event.commandId = commandId;
+    snprintf(event.extra, sizeof(event.extra), "%u %08lX frame=%lu", strip, hash, frame);
+    event.valid = true;
+    return enqueue(event);
+}
+
+bool EventQueue::queueLoad(uint8_t level, const char* name, uint8_t eventFill, uint8_t rxFill, uint32_t loopUs) {
+    Event event;
+    event.type = EventType::LOAD;
+    event.action[0] = '\0';
+    event.position = 0;
+    event.commandId = COMMAND_ID_NONE;
+    snprintf(event.extra, sizeof(event.extra), "%u %s events=%u rx=%u loop_us=%lu",
+             level, name, eventFill, rxFill, loopUs);
+    event.valid = true;
+    return enqueue(event);
+}
+
+bool EventQueue::queueBusRecovered(uint32_t outageMs, uint8_t sensorCount) {
+    Event event;
+    event.type = EventType::BUS_RECOVERED;
+    event.action[0] = '\0';
+    event.position = 0;
+    event.commandId = COMMAND_ID_NONE;
+    snprintf(event.extra, sizeof(event.extra), "ms=%lu sensors=%u", outageMs, sensorCount);
+    event.valid = true;
+    return enqueue(event);
+}
+
+/**
+ * @brief Queues "SEQ_TIMES <from> ms=<a>,<b>,...": reaction times from step from on
+ */
+bool EventQueue::queueSeqTimes(uint8_t fromStep, const char* times, uint32_t commandId) {
+    Event event;
+    event.type = EventType::SEQ_TIMES;
+    event.action[0] = '\0';
+    event.position = 0;
+    event.commandId = commandId;
+    snprintf(event.extra, sizeof(event.extra), "%u ms=%s", fromStep, times);
+    event.valid = true;
+    return enqueue(event);
+}
+
+bool EventQueue::queueReact(char position, uint32_t reactionUs, uint32_t commandId) {
+    Event event;
+    event.type = EventType::REACT;
+    event.action[0] = '\0';
+    event.position = position;
+    event.commandId = commandId;
+    snprintf(event.extra, sizeof(event.extra), "%lu", reactionUs);
+    event.valid = true;
+    return enqueue(event);
+}
+
 // ============================================================================
 // Private Methods
 // ============================================================================
 
+/**
+ * @brief Folds an ACK without #id into the newest queued event if that is one too
+ * 
+ * Only identical ACKs merge (same action and position), so the host
+ * never loses which positions were acknowledged. The merged line reads
+ * "ACK <action> [pos] +<n>": the same command without #id was accepted
+ * n more times.
+ */
+bool EventQueue::coalesceAck(const char* action, char position) {
+    bool merged = false;
+    
+    if (xSemaphoreTake(m_queueMutex, pdMS_TO_TICKS(MUTEX_TIMEOUT_QUEUE_MS)) == pdTRUE) {
+        if (m_count > 0) {
+            Event& newest = m_events[(m_head + QUEUE_SIZE_EVENTS - 1) % QUEUE_SIZE_EVENTS];
+            if (newest.type == EventType::ACK && newest.commandId == COMMAND_ID_NONE &&
+                newest.position == position &&
+                strncmp(newest.action, action, sizeof(newest.action) - 1) == 0) {
+                unsigned long extraAcks = (newest.extra[0] == '+') ? strtoul(newest.extra + 1, nullptr, 10) : 0;
+                snprintf(newest.extra, sizeof(newest.extra), "+%lu", extraAcks + 1);
+                merged = true;
+            }
+        }
+        xSemaphoreGive(m_queueMutex);
+    }
+    
+    return merged;
+}
+
 bool EventQueue::enqueue(const Event& event) {
     bool success = false;
     
@@ -227,6 +471,9 @@ bool EventQueue::enqueue(const Event& event) {
             m_events[m_head] = event;
             m_head = (m_head + 1) % QUEUE_SIZE_EVENTS;
             m_count++;
+            if (event.type == EventType::PIXELS) {
+                m_readbackCount++;
+            }
             success = true;
         }
         xSemaphoreGive(m_queueMutex);
@@ -251,6 +498,9 @@ void EventQueue::sendEvent(const Event& event) {
             if (event.position != 0) {
                 length += snprintf(buffer + length, sizeof(buffer) - length, " %c", event.position);
             }
+            if (event.extra[0] != '\0') {
+                length += snprintf(buffer + length, sizeof(buffer) - length, " %s", event.extra);
+            }
             break;
             
         case EventType::DONE:
@@ -258,6 +508,9 @@ void EventQueue::sendEvent(const Event& event) {
             if (event.position != 0) {
                 length += snprintf(buffer + length, sizeof(buffer) - length, " %c", event.position);
             }
+            if (event.extra[0] != '\0') {
+                length += snprintf(buffer + length, sizeof(buffer) - length, " %s", event.extra);
+            }
             break;
             
         case EventType::ERR:
@@ -270,10 +523,16 @@ void EventQueue::sendEvent(const Event& event) {
             
         case EventType::TOUCHED:
             length = snprintf(buffer, sizeof(buffer), "TOUCHED %c", event.position);
+            if (event.extra[0] != '\0') {
+                length += snprintf(buffer + length, sizeof(buffer) - length, " %s", event.extra);
+            }
             break;
             
         case EventType::TOUCH_RELEASED:
             length = snprintf(buffer, sizeof(buffer), "TOUCH_RELEASED %c", event.position);
+            if (event.extra[0] != '\0') {
+                length += snprintf(buffer + length, sizeof(buffer) - length, " %s", event.extra);
+            }
             break;
             
         case EventType::SCANNED:
@@ -296,6 +555,57 @@ void EventQueue::sendEvent(const Event& event) {
         case EventType::VALUE:
             length = snprintf(buffer, sizeof(buffer), "VALUE %c %s", event.position, event.extra);
             break;
+            
+        case EventType::ASSIGNED:
+            length = snprintf(buffer, sizeof(buffer), "ASSIGNED %c %s", event.position, event.extra);
+            break;
+            
+        case EventType::DISCOVERED:
+            length = snprintf(buffer, sizeof(buffer), "DISCOVERED %s", event.extra);
+            break;
+            
+        case EventType::SELFTEST:
+            length = snprintf(buffer, sizeof(buffer), "SELFTEST %s", event.extra);
+            break;
+            
+        case EventType::STATS:
+            length = snprintf(buffer, sizeof(buffer), "STATS %s", event.extra);
+            break;
+            
+        case EventType::FRAME:
+            length = snprintf(buffer, sizeof(buffer), "FRAME %s", event.extra);
+            break;
+            
+        case EventType::PIXELS:
+            length = snprintf(buffer, sizeof(buffer), "PIXELS %s", event.extra);
+            break;
+            
+        case EventType::FRAME_HASH:
+            length = snprintf(buffer, sizeof(buffer), "FRAME_HASH %s", event.extra);
+            break;
+            
+        case EventType::LOAD:
+            length = snprintf(buffer, sizeof(buffer), "LOAD %s", event.extra);
+            break;
+            
+        case EventType::BUS_RECOVERED:
+            length = snprintf(buffer, sizeof(buffer), "BUS_RECOVERED %s", event.extra);
+            break;
+            
+        case EventType::SEQ_TIMES:
+            length = snprintf(buffer, sizeof(buffer), "SEQ_TIMES %s", event.extra);
+            break;
+            
+        case EventType::REACT:
+            length = snprintf(buffer, sizeof(buffer), "REACT %c %s", event.position, event.extra);
+            break;
+            
+        case EventType::POWER:
+            length = snprintf(buffer, sizeof(buffer), "POWER %s", event.action);
+            if (event.extra[0] != '\0') {
+                length += snprintf(buffer + length, sizeof(buffer) - length, " %s", event.extra);
+            }
+            break;
     }
     
     // Append command ID if present
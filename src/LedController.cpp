@@ -56,6 +56,13 @@ LedController::LedController()
     , m_sequenceAnimStep(0)
     , m_sequenceAnimLastTime(0)
     , m_needsUpdate(false)
+    , m_frameCount(0)
+    , m_lastFrameTime(0)
+    , m_handedFrameCount(0)
+    , m_outputTask(nullptr)
+    , m_outputBusy(false)
+    , m_minFrameMs(0)
+    , m_skipSteps(false)
     , m_menuChangeActive(false)
     , m_menuChangeStep(0)
     , m_menuChangeRange(0)
@@ -63,7 +70,21 @@ LedController::LedController()
     , m_menuChangeG(0)
     , m_menuChangeB(0)
     , m_menuChangeLastTime(0)
+    , m_patternActive(false)
+    , m_patternId(0)
+    , m_patternFrame(0)
+    , m_patternLastTime(0)
 {
+    memset(m_frame1, 0, sizeof(m_frame1));
+    memset(m_frame2, 0, sizeof(m_frame2));
+    memset(m_meters, 0, sizeof(m_meters));
+    memset(m_scenes, 0, sizeof(m_scenes));
+    memset(m_frameTimes, 0, sizeof(m_frameTimes));
+    memset(m_colorTable, 0, sizeof(m_colorTable));
+    memset(m_colorHash, 0, sizeof(m_colorHash));
+    m_colorCount = 1;
+    m_lastColorIndex = 0;
+    m_colorTableCompacted = false;
 }
 
 // ============================================================================
@@ -75,6 +96,7 @@ void LedController::begin() {
     m_strip2.begin();
     m_strip1.setBrightness(LED_BRIGHTNESS_DEFAULT);
     m_strip2.setBrightness(LED_BRIGHTNESS_DEFAULT);
+    clearStrips();
     m_strip1.clear();
     m_strip2.clear();
     m_strip1.show();
@@ -86,10 +108,22 @@ void LedController::begin() {
         m_positions[i].lastAnimationTime = 0;
         m_positions[i].blinkOn = false;
         m_positions[i].expansionRadius = 0;
+        m_positions[i].color = RGB_SHOW;
+        m_positions[i].hueCycleMs = LED_HUE_CYCLE_DEFAULT_MS;
+        m_positions[i].hueCycleStart = 0;
+        m_positions[i].targetRadius = 0;
+        m_positions[i].expandStepMs = 0;
     }
     
+    for (uint8_t i = 0; i < LED_PALETTE_SIZE; i++) {
+        m_palette[i] = { LED_PALETTE_DEFAULTS[i][0], LED_PALETTE_DEFAULTS[i][1], LED_PALETTE_DEFAULTS[i][2] };
+    }
+    
+    clearMeters();
+    
     m_sequenceAnimActive = false;
     m_menuChangeActive = false;
+    m_patternActive = false;
     m_needsUpdate = false;
 }
 
@@ -98,12 +132,48 @@ void LedController::tick() {
 }
 
 void LedController::update(uint32_t nowMillis) {
-    // Update animations
+    // When skipping steps, late animations advance several steps into one frame
+    updateAnimations(nowMillis);
+    
+    // Hand the frame over once the output stage is done with the previous one;
+    // until then changes keep accumulating in the logical framebuffer
+    if (m_needsUpdate && !m_outputBusy && nowMillis - m_lastFrameTime >= m_minFrameMs) {
+        loadOutputBuffers();
+        m_needsUpdate = false;
+        m_handedFrameCount++;
+        m_colorTableCompacted = false;
+        
+        if (m_outputTask) {
+            m_outputBusy = true;
+            xTaskNotifyGive(m_outputTask);
+        } else {
+            showFrame();
+        }
+    }
+}
+
+void LedController::setOutputTask(TaskHandle_t task) {
+    m_outputTask = task;
+}
+
+/**
+ * @brief Output stage: waits for a handed-over frame and clocks it out
+ */
+void LedController::outputTick() {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    showFrame();
+}
+
+void LedController::updateAnimations(uint32_t nowMillis) {
     for (uint8_t i = 0; i < LED_POSITION_COUNT; i++) {
         if (m_positions[i].state == PositionState::ANIMATING) {
             updateAnimation(i, nowMillis);
         } else if (m_positions[i].state == PositionState::CONTRACTING) {
             updateContractAnimation(i, nowMillis);
+        } else if (m_positions[i].state == PositionState::HUE_CYCLING) {
+            updateHueCycle(i, nowMillis);
+        } else if (m_positions[i].state == PositionState::EXPANDING) {
+            updateExpandTo(i, nowMillis);
         }
     }
     
@@ -117,14 +187,12 @@ void LedController::update(uint32_t nowMillis) {
         updateMenuChangeAnimation(nowMillis);
     }
     
-    if (m_needsUpdate) {
-        m_strip1.show();
-        m_strip2.show();
-        m_needsUpdate = false;
+    if (m_patternActive) {
+        updatePattern(nowMillis);
     }
 }
 
-bool LedController::show(uint8_t position) {
+bool LedController::show(uint8_t position, const RgbColor& color) {
     if (position >= LED_POSITION_COUNT) return false;
     
     const LedMapping* mapping = getMapping(position);
@@ -139,8 +207,9 @@ bool LedController::show(uint8_t position) {
     m_positions[position].state = PositionState::SHOWN;
     m_positions[position].animationStep = 0;
     m_positions[position].expansionRadius = 0;
+    m_positions[position].color = color;
     
-    setLed(mapping->strip, mapping->index, COLOR_SHOW_R, COLOR_SHOW_G, COLOR_SHOW_B);
+    setLed(mapping->strip, mapping->index, color);
     m_needsUpdate = true;
     
     return true;
@@ -164,8 +233,7 @@ bool LedController::hide(uint8_t position) {
 }
 
 void LedController::hideAll() {
-    m_strip1.clear();
-    m_strip2.clear();
+    clearStrips();
     
     for (uint8_t i = 0; i < LED_POSITION_COUNT; i++) {
         m_positions[i].state = PositionState::OFF;
@@ -173,12 +241,14 @@ void LedController::hideAll() {
         m_positions[i].blinkOn = false;
         m_positions[i].expansionRadius = 0;
     }
+    clearMeters();
     m_sequenceAnimActive = false;
     m_menuChangeActive = false;
+    m_patternActive = false;
     m_needsUpdate = true;
 }
 
-bool LedController::success(uint8_t position) {
+bool LedController::success(uint8_t position, const RgbColor& color) {
     if (position >= LED_POSITION_COUNT) return false;
     
     const LedMapping* mapping = getMapping(position);
@@ -186,10 +256,12 @@ bool LedController::success(uint8_t position) {
     
     // If this position was already animating/expanded, clear its old region first
     if (m_positions[position].state == PositionState::ANIMATING ||
-        m_positions[position].state == PositionState::EXPANDED) {
+        m_positions[position].state == PositionState::EXPANDED ||
+        m_positions[position].expansionRadius > 0) {
         clearExpandedRegion(position, mapping);
     } else if (m_positions[position].state == PositionState::SHOWN ||
-               m_positions[position].state == PositionState::BLINKING) {
+               m_positions[position].state == PositionState::BLINKING ||
+               m_positions[position].state == PositionState::HUE_CYCLING) {
         // Just clear the single center LED
         setLed(mapping->strip, mapping->index, COLOR_OFF_R, COLOR_OFF_G, COLOR_OFF_B);
     }
@@ -197,9 +269,10 @@ bool LedController::success(uint8_t position) {
     m_positions[position].state = PositionState::ANIMATING;
     m_positions[position].animationStep = 0;
     m_positions[position].lastAnimationTime = millis();
+    m_positions[position].color = color;
     
-    // Set center LED to green immediately
-    setLed(mapping->strip, mapping->index, COLOR_SUCCESS_R, COLOR_SUCCESS_G, COLOR_SUCCESS_B);
+    // Set center LED to the success color immediately
+    setLed(mapping->strip, mapping->index, color);
     m_needsUpdate = true;
     
     return true;
@@ -212,14 +285,16 @@ bool LedController::fail(uint8_t position) {
     if (!mapping) return false;
     
     if (m_positions[position].state == PositionState::ANIMATING ||
-        m_positions[position].state == PositionState::EXPANDED) {
+        m_positions[position].state == PositionState::EXPANDED ||
+        m_positions[position].expansionRadius > 0) {
         clearExpandedRegion(position, mapping);
     }
     
     m_positions[position].state = PositionState::SHOWN;
     m_positions[position].animationStep = 0;
+    m_positions[position].color = RGB_FAIL;
     
-    setLed(mapping->strip, mapping->index, COLOR_FAIL_R, COLOR_FAIL_G, COLOR_FAIL_B);
+    setLed(mapping->strip, mapping->index, RGB_FAIL);
     m_needsUpdate = true;
     
     return true;
@@ -241,21 +316,23 @@ bool LedController::contract(uint8_t position) {
     } else {
         // If not expanded, just ensure it's shown as a single green LED
         m_positions[position].state = PositionState::SHOWN;
-        setLed(mapping->strip, mapping->index, COLOR_SUCCESS_R, COLOR_SUCCESS_G, COLOR_SUCCESS_B);
+        m_positions[position].color = RGB_SUCCESS;
+        setLed(mapping->strip, mapping->index, RGB_SUCCESS);
     }
     
     m_needsUpdate = true;
     return true;
 }
 
-bool LedController::blink(uint8_t position) {
+bool LedController::blink(uint8_t position, const RgbColor& color) {
     if (position >= LED_POSITION_COUNT) return false;
     
     const LedMapping* mapping = getMapping(position);
     if (!mapping) return false;
     
     if (m_positions[position].state == PositionState::ANIMATING ||
-        m_positions[position].state == PositionState::EXPANDED) {
+        m_positions[position].state == PositionState::EXPANDED ||
+        m_positions[position].expansionRadius > 0) {
         clearExpandedRegion(position, mapping);
     }
     
@@ -263,8 +340,9 @@ bool LedController::blink(uint8_t position) {
     m_positions[position].animationStep = 0;
     m_positions[position].lastAnimationTime = millis();
     m_positions[position].blinkOn = true;
+    m_positions[position].color = color;
     
-    setLed(mapping->strip, mapping->index, COLOR_BLINK_R, COLOR_BLINK_G, COLOR_BLINK_B);
+    setLed(mapping->strip, mapping->index, color);
     m_needsUpdate = true;
     
     return true;
@@ -310,8 +388,8 @@ bool LedController::expandStep(uint8_t position) {
     int16_t rightIndex = mapping->index + newRadius;
     
     // Set new outer LEDs to blue (same as SHOW color)
-    setLed(mapping->strip, leftIndex, COLOR_SHOW_R, COLOR_SHOW_G, COLOR_SHOW_B);
-    setLed(mapping->strip, rightIndex, COLOR_SHOW_R, COLOR_SHOW_G, COLOR_SHOW_B);
+    setLed(mapping->strip, leftIndex, RGB_SHOW);
+    setLed(mapping->strip, rightIndex, RGB_SHOW);
     
     // Update state
     m_positions[position].expansionRadius = newRadius;
@@ -354,13 +432,276 @@ bool LedController::contractStep(uint8_t position) {
     return true;
 }
 
+/**
+ * @brief Sets (durationMs = 0) or animates the lit region to an absolute radius
+ * 
+ * Takes over whatever region the position currently lights, including a
+ * SUCCESS expansion, and keeps the position's color. When animated, the
+ * radius moves one LED per step, spread evenly over durationMs.
+ */
+bool LedController::expandTo(uint8_t position, uint8_t radius, uint16_t durationMs) {
+    if (position >= LED_POSITION_COUNT) return false;
+    
+    const LedMapping* mapping = getMapping(position);
+    if (!mapping) return false;
+    if (radius > getMaxRadius(position)) return false;
+    
+    PositionData& data = m_positions[position];
+    
+    // Radius currently lit, whichever mechanism lit it
+    uint8_t current = data.expansionRadius;
+    if ((data.state == PositionState::ANIMATING || data.state == PositionState::EXPANDED ||
+         data.state == PositionState::CONTRACTING) && data.animationStep > current) {
+        current = data.animationStep;
+    }
+    
+    data.animationStep = 0;
+    data.blinkOn = false;
+    data.expansionRadius = current;
+    data.targetRadius = radius;
+    setRing(mapping, 0, data.color);
+    
+    if (durationMs == 0 || current == radius) {
+        for (uint8_t r = 1; r <= radius; r++) {
+            setRing(mapping, r, data.color);
+        }
+        for (uint8_t r = radius + 1; r <= current; r++) {
+            setRing(mapping, r, { COLOR_OFF_R, COLOR_OFF_G, COLOR_OFF_B });
+        }
+        data.expansionRadius = radius;
+        data.state = PositionState::SHOWN;
+    } else {
+        // Existing rings up to current stay lit; steps grow or shrink from there
+        for (uint8_t r = 1; r <= current; r++) {
+            setRing(mapping, r, data.color);
+        }
+        uint8_t steps = (radius > current) ? radius - current : current - radius;
+        data.expandStepMs = durationMs / steps;
+        data.lastAnimationTime = millis();
+        data.state = PositionState::EXPANDING;
+    }
+    
+    m_needsUpdate = true;
+    return true;
+}
+
+bool LedController::hueCycle(uint8_t position, uint16_t periodMs) {
+    if (position >= LED_POSITION_COUNT) return false;
+    if (periodMs == 0) return false;
+    
+    const LedMapping* mapping = getMapping(position);
+    if (!mapping) return false;
+    
+    if (m_positions[position].state == PositionState::ANIMATING ||
+        m_positions[position].state == PositionState::EXPANDED ||
+        m_positions[position].expansionRadius > 0) {
+        clearExpandedRegion(position, mapping);
+    }
+    
+    uint32_t now = millis();
+    
+    m_positions[position].state = PositionState::HUE_CYCLING;
+    m_positions[position].animationStep = 0;
+    m_positions[position].lastAnimationTime = now;
+    m_positions[position].hueCycleMs = periodMs;
+    m_positions[position].hueCycleStart = now;
+    m_positions[position].color = hsvToRgb(0, 255, 255);
+    
+    setLed(mapping->strip, mapping->index, m_positions[position].color);
+    m_needsUpdate = true;
+    return true;
+}
+
+/**
+ * @brief Sets a level bar across the LEDs from one position to another
+ * 
+ * Both positions must be on the same strip. Level 0-255 fills the span
+ * from the 'from' end; the LED at the edge of the fill gets the fractional
+ * part as brightness so the bar moves smoothly. A span keeps its slot
+ * across updates (in either direction) and only the LEDs between the old
+ * and new edge are rewritten. Level 0 clears the span and frees the slot.
+ * 
+ * @return false if the positions are on different strips or all
+ *         LED_METER_SLOTS are in use by other spans
+ */
+bool LedController::setMeter(uint8_t from, uint8_t to, uint8_t level, const RgbColor& color) {
+    if (from >= LED_POSITION_COUNT || to >= LED_POSITION_COUNT) return false;
+    
+    const LedMapping* fromMapping = getMapping(from);
+    const LedMapping* toMapping = getMapping(to);
+    if (!fromMapping || !toMapping || fromMapping->strip != toMapping->strip) return false;
+    
+    uint16_t spanLength = abs((int16_t)toMapping->index - (int16_t)fromMapping->index) + 1;
+    uint16_t fill = ((uint32_t)level * spanLength * 256 + 127) / 255;
+    
+    MeterData* meter = findMeter(from, to);
+    if (!meter) {
+        if (level == 0) return true;
+        
+        for (uint8_t i = 0; i < LED_METER_SLOTS && !meter; i++) {
+            if (!m_meters[i].active) meter = &m_meters[i];
+        }
+        if (!meter) return false;
+        
+        *meter = { true, from, to, fill, color };
+        renderMeter(*meter, 0, spanLength - 1);
+    } else if (meter->from != from || meter->color.r != color.r ||
+               meter->color.g != color.g || meter->color.b != color.b) {
+        // New direction or color: the whole span changes
+        *meter = { true, from, to, fill, color };
+        renderMeter(*meter, 0, spanLength - 1);
+    } else if (meter->fill != fill) {
+        // Only the LEDs between the old and the new edge change
+        uint16_t oldEdge = meter->fill >> 8;
+        uint16_t newEdge = fill >> 8;
+        meter->fill = fill;
+        renderMeter(*meter, min(oldEdge, newEdge), min<uint16_t>(max(oldEdge, newEdge), spanLength - 1));
+    } else {
+        return true;
+    }
+    
+    if (level == 0) meter->active = false;
+    m_needsUpdate = true;
+    return true;
+}
+
+/**
+ * @brief Whether a position's LED lies within the METER span from..to
+ */
+bool LedController::spanContains(uint8_t from, uint8_t to, uint8_t position) const {
+    const LedMapping* fromMapping = getMapping(from);
+    const LedMapping* toMapping = getMapping(to);
+    const LedMapping* mapping = getMapping(position);
+    if (!fromMapping || !toMapping || !mapping) return false;
+    if (mapping->strip != fromMapping->strip || mapping->strip != toMapping->strip) return false;
+    
+    uint16_t first = min(fromMapping->index, toMapping->index);
+    uint16_t last = max(fromMapping->index, toMapping->index);
+    return mapping->index >= first && mapping->index <= last;
+}
+
+/**
+ * @brief Captures every position and meter in its settled form
+ * 
+ * Animations in flight are stored as their end state: a SUCCESS expansion
+ * fully expanded, CONTRACT as the single LED, EXPAND_TO at its target.
+ */
+bool LedController::storeScene(uint8_t slot) {
+    if (slot >= SCENE_SLOTS) return false;
+    
+    LedScene& scene = m_scenes[slot];
+    for (uint8_t i = 0; i < LED_POSITION_COUNT; i++) {
+        const PositionData& data = m_positions[i];
+        ScenePosition& entry = scene.positions[i];
+        
+        entry.state = data.state;
+        entry.color = data.color;
+        entry.radius = data.expansionRadius;
+        entry.hueCycleMs = data.hueCycleMs;
+        
+        switch (data.state) {
+            case PositionState::ANIMATING:
+                entry.state = PositionState::EXPANDED;
+                break;
+            case PositionState::CONTRACTING:
+                entry.state = PositionState::SHOWN;
+                entry.radius = 0;
+                break;
+            case PositionState::EXPANDING:
+                entry.state = PositionState::SHOWN;
+                entry.radius = data.targetRadius;
+                break;
+            default:
+                break;
+        }
+    }
+    
+    memcpy(scene.meters, m_meters, sizeof(m_meters));
+    scene.stored = true;
+    return true;
+}
+
+/**
+ * @brief Replaces the whole board with a captured scene, drawn in one frame
+ * 
+ * Like HIDE_ALL, stops sequence, menu change and pattern animations first.
+ * Meters are drawn over positions. Blinking and hue cycling restart.
+ * Returns false for an empty slot.
+ */
+bool LedController::recallScene(uint8_t slot) {
+    if (slot >= SCENE_SLOTS || !m_scenes[slot].stored) return false;
+    
+    const LedScene& scene = m_scenes[slot];
+    hideAll();
+    uint32_t now = millis();
+    
+    for (uint8_t i = 0; i < LED_POSITION_COUNT; i++) {
+        const ScenePosition& entry = scene.positions[i];
+        const LedMapping* mapping = getMapping(i);
+        if (!mapping || entry.state == PositionState::OFF) continue;
+        
+        PositionData& data = m_positions[i];
+        data.state = entry.state;
+        data.color = entry.color;
+        data.lastAnimationTime = now;
+        
+        uint8_t radius = 0;
+        switch (entry.state) {
+            case PositionState::SHOWN:
+                data.expansionRadius = entry.radius;
+                radius = entry.radius;
+                break;
+            case PositionState::EXPANDED:
+                data.animationStep = LED_SUCCESS_EXPANSION_RADIUS;
+                radius = LED_SUCCESS_EXPANSION_RADIUS;
+                break;
+            case PositionState::BLINKING:
+                data.blinkOn = true;
+                break;
+            case PositionState::HUE_CYCLING:
+                data.hueCycleMs = entry.hueCycleMs;
+                data.hueCycleStart = now;
+                break;
+            default:
+                break;
+        }
+        
+        for (uint8_t r = 0; r <= radius; r++) {
+            setRing(mapping, r, entry.color);
+        }
+    }
+    
+    memcpy(m_meters, scene.meters, sizeof(m_meters));
+    for (uint8_t i = 0; i < LED_METER_SLOTS; i++) {
+        if (!m_meters[i].active) continue;
+        
+        uint16_t spanLength = abs((int16_t)getMapping(m_meters[i].to)->index -
+                                  (int16_t)getMapping(m_meters[i].from)->index) + 1;
+        renderMeter(m_meters[i], 0, spanLength - 1);
+    }
+    
+    m_needsUpdate = true;
+    return true;
+}
+
+bool LedController::setPaletteColor(uint8_t index, const RgbColor& color) {
+    if (index >= LED_PALETTE_SIZE) return false;
+    m_palette[index] = color;
+    return true;
+}
+
+bool LedController::getPaletteColor(uint8_t index, RgbColor& color) const {
+    if (index >= LED_PALETTE_SIZE) return false;
+    color = m_palette[index];
+    return true;
+}
+
 void LedController::startSequenceCompletedAnimation() {
     m_sequenceAnimActive = true;
     m_sequenceAnimStep = 0;
     m_sequenceAnimLastTime = millis();
     
-    m_strip1.clear();
-    m_strip2.clear();
+    clearStrips();
     m_needsUpdate = true;
 }
 
@@ -378,8 +719,7 @@ void LedController::startMenuChangeAnimation(uint8_t r, uint8_t g, uint8_t b, ui
     m_menuChangeLastTime = millis();
     
     // Clear both strips
-    m_strip1.clear();
-    m_strip2.clear();
+    clearStrips();
     m_needsUpdate = true;
 }
 
@@ -387,6 +727,25 @@ bool LedController::isMenuChangeAnimationComplete() const {
     return !m_menuChangeActive;
 }
 
+bool LedController::startPattern(uint8_t patternId) {
+    if (patternId >= LED_PATTERN_COUNT) return false;
+    
+    m_patternActive = true;
+    m_patternId = patternId;
+    m_patternFrame = 0;
+    
+    // Render frame 0 now; later frames follow every frameMs
+    m_patternLastTime = millis();
+    renderPatternFrame(StripId::STRIP1, LED_PATTERNS[patternId], 0);
+    renderPatternFrame(StripId::STRIP2, LED_PATTERNS[patternId], 0);
+    m_needsUpdate = true;
+    return true;
+}
+
+bool LedController::isPatternComplete() const {
+    return !m_patternActive;
+}
+
 bool LedController::isAnimationComplete(uint8_t position) const {
     if (position >= LED_POSITION_COUNT) return true;
     return m_positions[position].state != PositionState::ANIMATING;
@@ -402,6 +761,98 @@ bool LedController::isBlinking(uint8_t position) const {
     return m_positions[position].state == PositionState::BLINKING;
 }
 
+bool LedController::isExpandComplete(uint8_t position) const {
+    if (position >= LED_POSITION_COUNT) return true;
+    return m_positions[position].state != PositionState::EXPANDING;
+}
+
+/**
+ * @brief Largest radius that still lights a pixel on the position's strip
+ */
+uint8_t LedController::getMaxRadius(uint8_t position) const {
+    const LedMapping* mapping = getMapping(position);
+    if (!mapping) return 0;
+    
+    uint16_t toStart = mapping->index;
+    uint16_t toEnd = getStripLength(mapping->strip) - 1 - mapping->index;
+    uint16_t maxRadius = (toStart > toEnd) ? toStart : toEnd;
+    return (maxRadius > 255) ? 255 : (uint8_t)maxRadius;
+}
+
+void LedController::setMinFrameInterval(uint16_t ms) {
+    m_minFrameMs = ms;
+}
+
+void LedController::setSkipSteps(bool enabled) {
+    m_skipSteps = enabled;
+}
+
+uint32_t LedController::getFrameCount() const {
+    return m_frameCount;
+}
+
+uint32_t LedController::getLastFrameTime() const {
+    return m_lastFrameTime;
+}
+
+uint32_t LedController::getPendingFrame() const {
+    return m_needsUpdate ? m_handedFrameCount + 1 : m_handedFrameCount;
+}
+
+/**
+ * @brief Show time of a given frame, even if later frames were shown since
+ * 
+ * The main loop may first notice a frame after the output stage has shown
+ * the next one, so "the last frame time" can belong to a later frame.
+ */
+bool LedController::getFrameTime(uint32_t frame, FrameTime& time) const {
+    portENTER_CRITICAL(&m_frameMux);
+    time = m_frameTimes[frame % LED_FRAME_TIME_HISTORY];
+    portEXIT_CRITICAL(&m_frameMux);
+    return time.frame == frame && frame != 0;
+}
+
+/**
+ * @brief Copies count RGB triplets of the logical framebuffer starting at from
+ * 
+ * The logical framebuffer holds colors as rendered, before brightness
+ * scaling, including changes not yet shown.
+ */
+bool LedController::readPixels(StripId strip, uint16_t from, uint16_t count, uint8_t* rgb) const {
+    uint16_t length = getStripLength(strip);
+    if (from >= length || count > length - from) return false;
+    
+    if (!LED_INDEXED_FRAMEBUFFER) {
+        memcpy(rgb, getFrameBuffer(strip) + from * 3, count * 3);
+        return true;
+    }
+    
+    for (uint16_t i = 0; i < count; i++) {
+        loadPixel(strip, from + i, rgb + i * 3);
+    }
+    return true;
+}
+
+/**
+ * @brief FNV-1a hash of one strip's logical framebuffer
+ * 
+ * Hashes the RGB bytes, so the result does not depend on the framebuffer format.
+ */
+uint32_t LedController::frameHash(StripId strip) const {
+    uint16_t length = getStripLength(strip);
+    
+    uint32_t hash = 2166136261u;
+    for (uint16_t i = 0; i < length; i++) {
+        uint8_t rgb[3];
+        loadPixel(strip, i, rgb);
+        for (uint8_t c = 0; c < 3; c++) {
+            hash ^= rgb[c];
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
 uint8_t LedController::charToPosition(char c) {
     if (c >= 'a' && c <= 'y') c = c - 'a' + 'A';
     if (c >= 'A' && c <= 'Y') return c - 'A';
@@ -413,6 +864,32 @@ char LedController::positionToChar(uint8_t pos) {
     return '?';
 }
 
+/**
+ * @brief Integer HSV to RGB conversion (8-bit hue wheel, no floating point)
+ * 
+ * The wheel is split into 6 regions of ~43 steps; within a region one
+ * channel ramps while the other two are held at v and p = v*(1-s).
+ */
+RgbColor LedController::hsvToRgb(uint8_t h, uint8_t s, uint8_t v) {
+    if (s == 0) return { v, v, v };
+    
+    uint8_t region = h / 43;
+    uint8_t remainder = (h - region * 43) * 6;
+    
+    uint8_t p = (v * (255 - s)) >> 8;
+    uint8_t q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    uint8_t t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+    
+    switch (region) {
+        case 0:  return { v, t, p };
+        case 1:  return { q, v, p };
+        case 2:  return { p, v, t };
+        case 3:  return { p, q, v };
+        case 4:  return { t, p, v };
+        default: return { v, p, q };
+    }
+}
+
 // ============================================================================
 // Private Methods
 // ============================================================================
@@ -422,10 +899,6 @@ const LedMapping* LedController::getMapping(uint8_t position) const {
     return &LED_MAPPINGS[position];
 }
 
-Adafruit_NeoPixel* LedController::getStrip(StripId strip) {
-    return (strip == StripId::STRIP1) ? &m_strip1 : &m_strip2;
-}
-
 uint16_t LedController::getStripLength(StripId strip) const {
     return (strip == StripId::STRIP1) ? LED_STRIP_1_LENGTH : LED_STRIP_2_LENGTH;
 }
@@ -433,14 +906,190 @@ uint16_t LedController::getStripLength(StripId strip) const {
 void LedController::setLed(StripId strip, int16_t index, uint8_t r, uint8_t g, uint8_t b) {
     if (index < 0) return;
     
-    Adafruit_NeoPixel* stripPtr = getStrip(strip);
     uint16_t stripLen = getStripLength(strip);
     
     if (index < (int16_t)stripLen) {
-        stripPtr->setPixelColor(index, stripPtr->Color(r, g, b));
+        // Compose stage only; the strip buffers are loaded at hand-over
+        if (LED_INDEXED_FRAMEBUFFER) {
+            getFrameBuffer(strip)[index] = colorIndex(r, g, b);
+            return;
+        }
+        
+        uint8_t* pixel = getFrameBuffer(strip) + index * 3;
+        pixel[0] = r;
+        pixel[1] = g;
+        pixel[2] = b;
+    }
+}
+
+void LedController::clearStrips() {
+    memset(m_frame1, 0, sizeof(m_frame1));
+    memset(m_frame2, 0, sizeof(m_frame2));
+    
+    // Nothing on the strips refers to the color table any more
+    m_colorCount = 1;
+    m_lastColorIndex = 0;
+    memset(m_colorHash, 0, sizeof(m_colorHash));
+}
+
+void LedController::loadPixel(StripId strip, uint16_t index, uint8_t* rgb) const {
+    if (LED_INDEXED_FRAMEBUFFER) {
+        const RgbColor& color = m_colorTable[getFrameBuffer(strip)[index]];
+        rgb[0] = color.r;
+        rgb[1] = color.g;
+        rgb[2] = color.b;
+        return;
+    }
+    
+    memcpy(rgb, getFrameBuffer(strip) + index * 3, 3);
+}
+
+/**
+ * @brief Returns the color table index for a color, adding it if needed
+ * 
+ * Index 0 is always black. Lookups go through an open-addressing hash of
+ * the table, so a write costs a probe or two instead of a table scan. A
+ * full table is compacted (entries no pixel uses any more are dropped) at
+ * most once per handed-over frame; if it is still full the nearest
+ * existing color is used.
+ */
+uint8_t LedController::colorIndex(uint8_t r, uint8_t g, uint8_t b) {
+    const RgbColor& last = m_colorTable[m_lastColorIndex];
+    if (last.r == r && last.g == g && last.b == b) return m_lastColorIndex;
+    if (r == 0 && g == 0 && b == 0) return 0;
+    
+    uint8_t slot = colorHashSlot(r, g, b);
+    while (m_colorHash[slot] != 0) {
+        const RgbColor& entry = m_colorTable[m_colorHash[slot]];
+        if (entry.r == r && entry.g == g && entry.b == b) {
+            m_lastColorIndex = m_colorHash[slot];
+            return m_lastColorIndex;
+        }
+        slot = (slot + 1) % LED_COLOR_HASH_SIZE;
+    }
+    
+    if (m_colorCount >= LED_COLOR_TABLE_SIZE && !m_colorTableCompacted) {
+        compactColorTable();
+        
+        // Renumbering moved the hash slots; find the free one again
+        slot = colorHashSlot(r, g, b);
+        while (m_colorHash[slot] != 0) slot = (slot + 1) % LED_COLOR_HASH_SIZE;
+    }
+    
+    if (m_colorCount < LED_COLOR_TABLE_SIZE) {
+        m_colorTable[m_colorCount] = { r, g, b };
+        m_colorHash[slot] = m_colorCount;
+        m_lastColorIndex = m_colorCount++;
+        return m_lastColorIndex;
+    }
+    
+    uint16_t bestDistance = 0xFFFF;
+    uint8_t best = 0;
+    for (uint8_t i = 0; i < m_colorCount; i++) {
+        const RgbColor& entry = m_colorTable[i];
+        uint16_t distance = abs(entry.r - r) + abs(entry.g - g) + abs(entry.b - b);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Drops color table entries no pixel refers to and renumbers the rest
+ * 
+ * Walks every pixel twice, so colorIndex() runs it at most once per frame.
+ */
+void LedController::compactColorTable() {
+    uint8_t remap[LED_COLOR_TABLE_SIZE];
+    bool used[LED_COLOR_TABLE_SIZE] = { true };  // Black stays at 0
+    
+    for (uint16_t i = 0; i < sizeof(m_frame1); i++) used[m_frame1[i]] = true;
+    for (uint16_t i = 0; i < sizeof(m_frame2); i++) used[m_frame2[i]] = true;
+    
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < m_colorCount; i++) {
+        if (!used[i]) continue;
+        m_colorTable[count] = m_colorTable[i];
+        remap[i] = count++;
+    }
+    
+    for (uint16_t i = 0; i < sizeof(m_frame1); i++) m_frame1[i] = remap[m_frame1[i]];
+    for (uint16_t i = 0; i < sizeof(m_frame2); i++) m_frame2[i] = remap[m_frame2[i]];
+    
+    m_colorCount = count;
+    m_lastColorIndex = 0;
+    m_colorTableCompacted = true;
+    rebuildColorHash();
+}
+
+void LedController::rebuildColorHash() {
+    memset(m_colorHash, 0, sizeof(m_colorHash));
+    
+    for (uint8_t i = 1; i < m_colorCount; i++) {
+        const RgbColor& entry = m_colorTable[i];
+        uint8_t slot = colorHashSlot(entry.r, entry.g, entry.b);
+        while (m_colorHash[slot] != 0) slot = (slot + 1) % LED_COLOR_HASH_SIZE;
+        m_colorHash[slot] = i;
+    }
+}
+
+uint8_t LedController::colorHashSlot(uint8_t r, uint8_t g, uint8_t b) {
+    uint32_t key = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    return ((uint32_t)(key * 2654435761UL) >> 16) % LED_COLOR_HASH_SIZE;
+}
+
+/**
+ * @brief Copies the logical framebuffer into the strip buffers (brightness applied)
+ * 
+ * Indexed pixels are expanded here; the strips keep their own GRB buffers.
+ */
+void LedController::loadOutputBuffers() {
+    uint8_t rgb[3];
+    for (uint16_t i = 0; i < LED_STRIP_1_LENGTH; i++) {
+        loadPixel(StripId::STRIP1, i, rgb);
+        m_strip1.setPixelColor(i, rgb[0], rgb[1], rgb[2]);
+    }
+    for (uint16_t i = 0; i < LED_STRIP_2_LENGTH; i++) {
+        loadPixel(StripId::STRIP2, i, rgb);
+        m_strip2.setPixelColor(i, rgb[0], rgb[1], rgb[2]);
     }
 }
 
+void LedController::showFrame() {
+    m_strip1.show();
+    m_strip2.show();
+    
+    // show() returns once the data is on the wire, so this is the time
+    // the frame became visible
+    FrameTime shown;
+    shown.shownMicros = micros();
+    shown.shownMillis = millis();
+    
+    // The main loop reads these on the other core; publish them together,
+    // and only then give the strip buffers back
+    portENTER_CRITICAL(&m_frameMux);
+    shown.frame = m_frameCount + 1;
+    m_frameTimes[shown.frame % LED_FRAME_TIME_HISTORY] = shown;
+    m_lastFrameTime = shown.shownMillis;
+    m_frameCount = shown.frame;
+    m_outputBusy = false;
+    portEXIT_CRITICAL(&m_frameMux);
+}
+
+uint8_t* LedController::getFrameBuffer(StripId strip) {
+    return (strip == StripId::STRIP1) ? m_frame1 : m_frame2;
+}
+
+const uint8_t* LedController::getFrameBuffer(StripId strip) const {
+    return (strip == StripId::STRIP1) ? m_frame1 : m_frame2;
+}
+
+void LedController::setLed(StripId strip, int16_t index, const RgbColor& color) {
+    setLed(strip, index, color.r, color.g, color.b);
+}
+
 void LedController::clearExpandedRegion(uint8_t position, const LedMapping* mapping) {
     if (!mapping) return;
     
@@ -464,16 +1113,36 @@ void LedController::clearExpandedRegion(uint8_t position, const LedMapping* mapp
     m_positions[position].expansionRadius = 0;
 }
 
+/**
+ * @brief Number of animation steps due now (0 = none), advancing the timestamp
+ * 
+ * Normally one step, timed from now. When skipping steps, every elapsed step
+ * is due (at most LOAD_MAX_CATCHUP_STEPS) and the timestamp moves by exactly
+ * that many, so the animation advances by all of them and renders once.
+ */
+uint8_t LedController::dueSteps(uint32_t& lastTime, uint32_t nowMillis, uint16_t stepMs) const {
+    uint32_t elapsed = nowMillis - lastTime;
+    if (elapsed < stepMs) return 0;
+    if (!m_skipSteps) {
+        lastTime = nowMillis;
+        return 1;
+    }
+    
+    uint32_t steps = (stepMs > 0) ? min<uint32_t>(elapsed / stepMs, LOAD_MAX_CATCHUP_STEPS) : LOAD_MAX_CATCHUP_STEPS;
+    lastTime += steps * stepMs;
+    return steps;
+}
+
 void LedController::updateAnimation(uint8_t position, uint32_t nowMillis) {
     PositionData& data = m_positions[position];
     
-    if (nowMillis - data.lastAnimationTime < LED_ANIMATION_STEP_MS) return;
-    
     const LedMapping* mapping = getMapping(position);
     if (!mapping) return;
     
-    data.animationStep++;
-    data.lastAnimationTime = nowMillis;
+    uint8_t steps = dueSteps(data.lastAnimationTime, nowMillis, LED_ANIMATION_STEP_MS);
+    if (steps == 0) return;
+    
+    data.animationStep = min<uint16_t>(data.animationStep + steps, LED_SUCCESS_EXPANSION_RADIUS + 1);
     
     if (data.animationStep > LED_SUCCESS_EXPANSION_RADIUS) {
         data.animationStep = LED_SUCCESS_EXPANSION_RADIUS;
@@ -485,17 +1154,17 @@ void LedController::updateAnimation(uint8_t position, uint32_t nowMillis) {
     int16_t center = mapping->index;
     
     // Always set center LED
-    setLed(mapping->strip, center, COLOR_SUCCESS_R, COLOR_SUCCESS_G, COLOR_SUCCESS_B);
+    setLed(mapping->strip, center, data.color);
     
     // Set all expanded LEDs up to current step
     for (uint8_t r = 1; r <= data.animationStep; r++) {
         int16_t leftIdx = center - r;
         if (leftIdx >= 0) {
-            setLed(mapping->strip, leftIdx, COLOR_SUCCESS_R, COLOR_SUCCESS_G, COLOR_SUCCESS_B);
+            setLed(mapping->strip, leftIdx, data.color);
         }
         int16_t rightIdx = center + r;
         if (rightIdx < (int16_t)stripLen) {
-            setLed(mapping->strip, rightIdx, COLOR_SUCCESS_R, COLOR_SUCCESS_G, COLOR_SUCCESS_B);
+            setLed(mapping->strip, rightIdx, data.color);
         }
     }
     
@@ -505,18 +1174,17 @@ void LedController::updateAnimation(uint8_t position, uint32_t nowMillis) {
 void LedController::updateContractAnimation(uint8_t position, uint32_t nowMillis) {
     PositionData& data = m_positions[position];
     
-    if (nowMillis - data.lastAnimationTime < LED_ANIMATION_STEP_MS) return;
-    
     const LedMapping* mapping = getMapping(position);
     if (!mapping) return;
     
-    data.lastAnimationTime = nowMillis;
+    uint8_t steps = dueSteps(data.lastAnimationTime, nowMillis, LED_ANIMATION_STEP_MS);
+    if (steps == 0) return;
     
     uint16_t stripLen = getStripLength(mapping->strip);
     int16_t center = mapping->index;
     
-    // Turn off the outermost LEDs at current radius
-    if (data.animationStep > 0) {
+    // Turn off the outermost LEDs at current radius, once per due step
+    for (; steps > 0 && data.animationStep > 0; steps--) {
         int16_t leftIdx = center - data.animationStep;
         if (leftIdx >= 0) {
             setLed(mapping->strip, leftIdx, COLOR_OFF_R, COLOR_OFF_G, COLOR_OFF_B);
@@ -528,8 +1196,8 @@ void LedController::updateContractAnimation(uint8_t position, uint32_t nowMillis
         data.animationStep--;
     }
     
-    // Keep center LED green
-    setLed(mapping->strip, center, COLOR_SUCCESS_R, COLOR_SUCCESS_G, COLOR_SUCCESS_B);
+    // Keep center LED in the success color
+    setLed(mapping->strip, center, data.color);
     
     // Check if contraction is complete
     if (data.animationStep == 0) {
@@ -551,7 +1219,7 @@ void LedController::updateBlinking(uint32_t nowMillis) {
                 const LedMapping* mapping = getMapping(i);
                 if (mapping) {
                     if (data.blinkOn) {
-                        setLed(mapping->strip, mapping->index, COLOR_BLINK_R, COLOR_BLINK_G, COLOR_BLINK_B);
+                        setLed(mapping->strip, mapping->index, data.color);
                     } else {
                         setLed(mapping->strip, mapping->index, COLOR_OFF_R, COLOR_OFF_G, COLOR_OFF_B);
                     }
@@ -562,23 +1230,111 @@ void LedController::updateBlinking(uint32_t nowMillis) {
     }
 }
 
+void LedController::updateHueCycle(uint8_t position, uint32_t nowMillis) {
+    PositionData& data = m_positions[position];
+    
+    if (nowMillis - data.lastAnimationTime < LED_ANIMATION_STEP_MS) return;
+    
+    const LedMapping* mapping = getMapping(position);
+    if (!mapping) return;
+    
+    data.lastAnimationTime = nowMillis;
+    
+    uint32_t phase = (nowMillis - data.hueCycleStart) % data.hueCycleMs;
+    uint8_t hue = (phase * 256) / data.hueCycleMs;
+    data.color = hsvToRgb(hue, 255, 255);
+    
+    setLed(mapping->strip, mapping->index, data.color);
+    m_needsUpdate = true;
+}
+
+void LedController::updateExpandTo(uint8_t position, uint32_t nowMillis) {
+    PositionData& data = m_positions[position];
+    
+    const LedMapping* mapping = getMapping(position);
+    if (!mapping) return;
+    
+    uint8_t steps = dueSteps(data.lastAnimationTime, nowMillis, data.expandStepMs);
+    if (steps == 0) return;
+    
+    for (; steps > 0 && data.expansionRadius != data.targetRadius; steps--) {
+        if (data.expansionRadius < data.targetRadius) {
+            data.expansionRadius++;
+            setRing(mapping, data.expansionRadius, data.color);
+        } else {
+            setRing(mapping, data.expansionRadius, { COLOR_OFF_R, COLOR_OFF_G, COLOR_OFF_B });
+            data.expansionRadius--;
+        }
+    }
+    
+    if (data.expansionRadius == data.targetRadius) {
+        data.state = PositionState::SHOWN;
+    }
+    
+    m_needsUpdate = true;
+}
+
+/**
+ * @brief Sets the two LEDs at distance radius from the center (one LED for 0)
+ */
+void LedController::setRing(const LedMapping* mapping, uint8_t radius, const RgbColor& color) {
+    setLed(mapping->strip, (int16_t)mapping->index - radius, color);
+    if (radius > 0) {
+        setLed(mapping->strip, (int16_t)mapping->index + radius, color);
+    }
+}
+
+MeterData* LedController::findMeter(uint8_t from, uint8_t to) {
+    for (uint8_t i = 0; i < LED_METER_SLOTS; i++) {
+        if (m_meters[i].active && ((m_meters[i].from == from && m_meters[i].to == to) ||
+                                   (m_meters[i].from == to && m_meters[i].to == from))) {
+            return &m_meters[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Writes LEDs firstLed..lastLed of a meter span (0 = 'from' end)
+ */
+void LedController::renderMeter(const MeterData& meter, uint16_t firstLed, uint16_t lastLed) {
+    const LedMapping* fromMapping = getMapping(meter.from);
+    const LedMapping* toMapping = getMapping(meter.to);
+    int8_t direction = (toMapping->index >= fromMapping->index) ? 1 : -1;
+    
+    uint16_t fullLeds = meter.fill >> 8;
+    uint8_t edgeLevel = meter.fill & 0xFF;
+    
+    for (uint16_t i = firstLed; i <= lastLed; i++) {
+        uint16_t level = (i < fullLeds) ? 256 : (i == fullLeds) ? edgeLevel : 0;
+        setLed(fromMapping->strip, (int16_t)fromMapping->index + direction * (int16_t)i,
+               (meter.color.r * level) >> 8, (meter.color.g * level) >> 8, (meter.color.b * level) >> 8);
+    }
+}
+
+void LedController::clearMeters() {
+    for (uint8_t i = 0; i < LED_METER_SLOTS; i++) {
+        m_meters[i].active = false;
+    }
+}
+
 void LedController::updateSequenceCompletedAnimation(uint32_t nowMillis) {
-    if (nowMillis - m_sequenceAnimLastTime < LED_SEQUENCE_STEP_MS) return;
+    uint8_t steps = dueSteps(m_sequenceAnimLastTime, nowMillis, LED_SEQUENCE_STEP_MS);
+    if (steps == 0) return;
     
-    m_sequenceAnimStep++;
-    m_sequenceAnimLastTime = nowMillis;
+    m_sequenceAnimStep += steps;
     
     uint16_t totalSteps = LED_SEQUENCE_PULSE_COUNT * LED_SEQUENCE_PULSE_STEPS * 2;
     
     if (m_sequenceAnimStep >= totalSteps) {
-        m_strip1.clear();
-        m_strip2.clear();
+        clearStrips();
         m_needsUpdate = true;
         
         for (uint8_t i = 0; i < LED_POSITION_COUNT; i++) {
             m_positions[i].state = PositionState::OFF;
             m_positions[i].animationStep = 0;
         }
+        clearMeters();
         
         m_sequenceAnimActive = false;
         return;
@@ -596,29 +1352,146 @@ void LedController::updateSequenceCompletedAnimation(uint32_t nowMillis) {
     }
     
     for (uint16_t i = 0; i < LED_STRIP_1_LENGTH; i++) {
-        m_strip1.setPixelColor(i, m_strip1.Color(0, brightness, 0));
+        setLed(StripId::STRIP1, i, 0, brightness, 0);
     }
     for (uint16_t i = 0; i < LED_STRIP_2_LENGTH; i++) {
-        m_strip2.setPixelColor(i, m_strip2.Color(0, brightness, 0));
+        setLed(StripId::STRIP2, i, 0, brightness, 0);
     }
     m_needsUpdate = true;
 }
 
 void LedController::updateMenuChangeAnimation(uint32_t nowMillis) {
-    if (nowMillis - m_menuChangeLastTime < LED_MENU_CHANGE_STEP_MS) return;
-    
-    m_menuChangeLastTime = nowMillis;
+    uint8_t steps = dueSteps(m_menuChangeLastTime, nowMillis, LED_MENU_CHANGE_STEP_MS);
     
     // Expand by one LED on each step
-    if (m_menuChangeStep <= m_menuChangeRange) {
-        // Light up the current step index on both strips
-        m_strip1.setPixelColor(m_menuChangeStep, m_strip1.Color(m_menuChangeR, m_menuChangeG, m_menuChangeB));
-        m_strip2.setPixelColor(m_menuChangeStep, m_strip2.Color(m_menuChangeR, m_menuChangeG, m_menuChangeB));
+    for (; steps > 0; steps--) {
+        if (m_menuChangeStep <= m_menuChangeRange) {
+            // Light up the current step index on both strips
+            setLed(StripId::STRIP1, m_menuChangeStep, m_menuChangeR, m_menuChangeG, m_menuChangeB);
+            setLed(StripId::STRIP2, m_menuChangeStep, m_menuChangeR, m_menuChangeG, m_menuChangeB);
+            m_needsUpdate = true;
+            
+            m_menuChangeStep++;
+        } else {
+            // Animation complete
+            m_menuChangeActive = false;
+            return;
+        }
+    }
+}
+
+void LedController::updatePattern(uint32_t nowMillis) {
+    const PatternDef& def = LED_PATTERNS[m_patternId];
+    
+    uint8_t steps = dueSteps(m_patternLastTime, nowMillis, def.frameMs);
+    if (steps == 0) return;
+    
+    m_patternFrame += steps;
+    
+    if (m_patternFrame >= def.frameCount) {
+        // Same ending as SEQUENCE_COMPLETED: board dark, positions OFF
+        clearStrips();
         m_needsUpdate = true;
         
-        m_menuChangeStep++;
-    } else {
-        // Animation complete
-        m_menuChangeActive = false;
+        for (uint8_t i = 0; i < LED_POSITION_COUNT; i++) {
+            m_positions[i].state = PositionState::OFF;
+            m_positions[i].animationStep = 0;
+            m_positions[i].expansionRadius = 0;
+        }
+        clearMeters();
+        
+        m_patternActive = false;
+        return;
+    }
+    
+    renderPatternFrame(StripId::STRIP1, def, m_patternFrame);
+    renderPatternFrame(StripId::STRIP2, def, m_patternFrame);
+    m_needsUpdate = true;
+}
+
+/**
+ * @brief Evaluates a pattern generator for every pixel of one strip
+ * 
+ * Generators are pure functions of (pixel, frame), so each frame is
+ * written straight into the strip buffer without any per-pattern state.
+ */
+void LedController::renderPatternFrame(StripId strip, const PatternDef& def, uint16_t frame) {
+    RgbColor base = { def.r, def.g, def.b };
+    uint16_t length = getStripLength(strip);
+    
+    for (uint16_t i = 0; i < length; i++) {
+        RgbColor c = { COLOR_OFF_R, COLOR_OFF_G, COLOR_OFF_B };
+        
+        switch (def.generator) {
+            case PatternGenerator::RAINBOW:
+                c = hsvToRgb((uint8_t)((i * 256) / length + frame * def.param), 255, 255);
+                break;
+                
+            case PatternGenerator::CHASE:
+                if (def.param > 0 && (i + frame) % def.param == 0) c = base;
+                break;
+                
+            case PatternGenerator::COMET: {
+                // Head sweeps 0..length-1 and leaves the strip before wrapping
+                int32_t head = frame % (length + def.param);
+                int32_t behind = head - (int32_t)i;
+                if (behind >= 0 && behind <= def.param) {
+                    uint16_t level = 255 - (behind * 255) / (def.param + 1);
+                    c = { (uint8_t)((base.r * level) >> 8), (uint8_t)((base.g * level) >> 8),
+                          (uint8_t)((base.b * level) >> 8) };
+                }
+                break;
+            }
+                
+            case PatternGenerator::BREATHE: {
+                if (def.param == 0) break;
+                uint16_t phase = frame % (def.param * 2);
+                uint16_t level = (phase < def.param) ? phase : (def.param * 2 - phase);
+                level = (level * 255) / def.param;
+                c = { (uint8_t)((base.r * level) >> 8), (uint8_t)((base.g * level) >> 8),
+                      (uint8_t)((base.b * level) >> 8) };
+                break;
+            }
+                
+            case PatternGenerator::GRADIENT:
+                c = gradientColor(def.param, (uint8_t)((i * 256) / length + frame));
+                break;
+                
+            case PatternGenerator::SPARKLE: {
+                // Cheap integer hash so the same frame always renders the same way
+                uint32_t h = (i * 2654435761u) ^ (frame * 40503u);
+                h ^= h >> 15;
+                h *= 2246822519u;
+                h ^= h >> 13;
+                if ((h & 0xFF) < def.param) c = base;
+                break;
+            }
+                
+            case PatternGenerator::WIPE:
+                if ((uint32_t)i * def.frameCount < (uint32_t)(frame + 1) * length) c = base;
+                break;
+        }
+        
+        setLed(strip, i, c);
     }
 }
+
+/**
+ * @brief Samples a wrapped gradient at position 0-255
+ */
+RgbColor LedController::gradientColor(uint8_t gradient, uint8_t position) {
+    constexpr uint8_t gradientCount = sizeof(LED_PATTERN_GRADIENTS) / sizeof(LED_PATTERN_GRADIENTS[0]);
+    if (gradient >= gradientCount) gradient = 0;
+    
+    constexpr uint16_t segment = 256 / LED_PATTERN_GRADIENT_STOPS;
+    uint8_t stop = position / segment;
+    uint8_t next = (stop + 1) % LED_PATTERN_GRADIENT_STOPS;
+    uint16_t t = ((position % segment) * 256) / segment;
+    
+    const uint8_t* a = LED_PATTERN_GRADIENTS[gradient][stop];
+    const uint8_t* b = LED_PATTERN_GRADIENTS[gradient][next];
+    
+    return { (uint8_t)(a[0] + (((int16_t)b[0] - a[0]) * (int16_t)t >> 8)),
+             (uint8_t)(a[1] + (((int16_t)b[1] - a[1]) * (int16_t)t >> 8)),
+             (uint8_t)(a[2] + (((int16_t)b[2] - a[2]) * (int16_t)t >> 8)) };
+}
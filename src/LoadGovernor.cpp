@@ -0,0 +1,138 @@
+/**
+ * @file LoadGovernor.cpp
+ * @brief Overload governor implementation
+ */
+
+#include "LoadGovernor.h"
+#include "LedController.h"
+#include "CommandController.h"
+#include "EventQueue.h"
+
+// ============================================================================
+// Constructor
+// ============================================================================
+
+LoadGovernor::LoadGovernor(LedController& ledController,
+                           CommandController& commandController,
+                           EventQueue& eventQueue)
+    : m_ledController(ledController)
+    , m_commandController(commandController)
+    , m_eventQueue(eventQueue)
+    , m_level(LoadLevel::NORMAL)
+    , m_lastEvalTime(0)
+    , m_releasePending(false)
+    , m_releaseStart(0)
+    , m_peakLoopUs(0)
+{
+}
+
+// ============================================================================
+// Public Methods
+// ============================================================================
+
+void LoadGovernor::begin() {
+    m_level = LoadLevel::NORMAL;
+    m_lastEvalTime = millis();
+    m_releasePending = false;
+    m_peakLoopUs = 0;
+    
+    m_ledController.setMinFrameInterval(0);
+    m_ledController.setSkipSteps(false);
+    m_eventQueue.setCoalesceAcks(false);
+    m_commandController.setRejectNew(false);
+}
+
+/**
+ * @brief Called once per main loop pass with the duration of that pass
+ * 
+ * Levels go up as soon as pressure reaches a threshold, and come down one
+ * at a time after pressure has stayed clearly below for LOAD_RELEASE_MS.
+ */
+void LoadGovernor::tick(uint32_t loopTimeUs) {
+    if (loopTimeUs > m_peakLoopUs) {
+        m_peakLoopUs = loopTimeUs;
+    }
+    
+    uint32_t now = millis();
+    if (now - m_lastEvalTime < LOAD_EVAL_INTERVAL_MS) return;
+    m_lastEvalTime = now;
+    
+    // GET_FRAME chunks fill the queue by design; they are planned, not load
+    uint8_t queued = m_eventQueue.count() - min(m_eventQueue.readbackCount(), m_eventQueue.count());
+    uint8_t eventFill = (uint16_t)queued * 100 / QUEUE_SIZE_EVENTS;
+    uint8_t rxFill = m_commandController.getRxFillPercent();
+    uint32_t loopUs = m_peakLoopUs;
+    uint8_t loopLoad = (uint8_t)min<uint32_t>(loopUs * 100 / LOAD_LOOP_BUDGET_US, 100);
+    m_peakLoopUs = 0;
+    
+    uint8_t pressure = max(eventFill, max(rxFill, loopLoad));
+    
+    LoadLevel target = LoadLevel::NORMAL;
+    for (uint8_t i = (uint8_t)LoadLevel::REJECT; i > (uint8_t)LoadLevel::NORMAL; i--) {
+        if (pressure >= levelThreshold((LoadLevel)i)) {
+            target = (LoadLevel)i;
+            break;
+        }
+    }
+    
+    if (target > m_level) {
+        m_releasePending = false;
+        setLevel(target, eventFill, rxFill, loopUs);
+        return;
+    }
+    
+    if (m_level == LoadLevel::NORMAL ||
+        pressure + LOAD_HYSTERESIS_PCT >= levelThreshold(m_level)) {
+        m_releasePending = false;
+        return;
+    }
+    
+    if (!m_releasePending) {
+        m_releasePending = true;
+        m_releaseStart = now;
+    } else if (now - m_releaseStart >= LOAD_RELEASE_MS) {
+        // Next level down needs its own quiet period
+        m_releaseStart = now;
+        setLevel((LoadLevel)((uint8_t)m_level - 1), eventFill, rxFill, loopUs);
+    }
+}
+
+LoadLevel LoadGovernor::getLevel() const {
+    return m_level;
+}
+
+const char* LoadGovernor::levelToString(LoadLevel level) {
+    switch (level) {
+        case LoadLevel::NORMAL: return "NORMAL";
+        case LoadLevel::FRAME_RATE: return "FRAME_RATE";
+        case LoadLevel::SKIP_STEPS: return "SKIP_STEPS";
+        case LoadLevel::COALESCE_ACKS: return "COALESCE_ACKS";
+        case LoadLevel::REJECT: return "REJECT";
+        default: return "UNKNOWN";
+    }
+}
+
+// ============================================================================
+// Private Methods
+// ============================================================================
+
+uint8_t LoadGovernor::levelThreshold(LoadLevel level) {
+    switch (level) {
+        case LoadLevel::FRAME_RATE: return LOAD_THRESHOLD_FRAME_RATE_PCT;
+        case LoadLevel::SKIP_STEPS: return LOAD_THRESHOLD_SKIP_STEPS_PCT;
+        case LoadLevel::COALESCE_ACKS: return LOAD_THRESHOLD_COALESCE_PCT;
+        case LoadLevel::REJECT: return LOAD_THRESHOLD_REJECT_PCT;
+        default: return 0;
+    }
+}
+
+void LoadGovernor::setLevel(LoadLevel level, uint8_t eventFill, uint8_t rxFill, uint32_t loopUs) {
+    m_level = level;
+    
+    m_ledController.setMinFrameInterval(level >= LoadLevel::FRAME_RATE ? LOAD_REDUCED_FRAME_MS : 0);
+    m_ledController.setSkipSteps(level >= LoadLevel::SKIP_STEPS);
+    m_eventQueue.setCoalesceAcks(level >= LoadLevel::COALESCE_ACKS);
+    m_commandController.setRejectNew(level >= LoadLevel::REJECT);
+    
+    m_eventQueue.queueLoad((uint8_t)level, levelToString(level), eventFill, rxFill, loopUs);
+}
@@ -4,6 +4,7 @@
  */
 
 #include "TouchController.h"
+#include <Preferences.h>
 #include "EventQueue.h"
 
 // ============================================================================
@@ -14,6 +15,43 @@ TouchController::TouchController()
     : m_eventQueue(nullptr)
     , m_lastPollTime(0)
     , m_activeSensorCount(0)
+    , m_discoveredCount(0)
+    , m_injectQueue(nullptr)
+    , m_pendingInjectionCount(0)
+    , m_scriptRequested(false)
+    , m_scriptStopRequested(false)
+    , m_scriptActive(false)
+    , m_scriptOverflowed(false)
+    , m_sensorRequestQueue(nullptr)
+    , m_sensorResultQueue(nullptr)
+    , m_requestSequence(0)
+    , m_startedSequence(0)
+    , m_cancelledSequence(0)
+    , m_edgeQueue(nullptr)
+    , m_edgeListener(false)
+    , m_reactArmed(false)
+    , m_reactStarted(false)
+    , m_reactDone(false)
+    , m_reactSensor(0)
+    , m_reactStartMicros(0)
+    , m_reactUs(0)
+    , m_busRequest(BusRequestType::NONE)
+    , m_busRequestAddress(0)
+    , m_busRequestSensor(0)
+    , m_busRequestCommandId(COMMAND_ID_NONE)
+    , m_busRequestTime(0)
+    , m_assignPollTime(0)
+    , m_powerMode(SensorPowerMode::ACTIVE)
+    , m_wakeRequested(false)
+    , m_wakeRequestMicros(0)
+    , m_lastActivityTime(0)
+    , m_lastWakeLatencyUs(0)
+    , m_failedSweeps(0)
+    , m_busFailTime(0)
+    , m_lastRecoveryTime(0)
+    , m_selfTestPhase(SelfTestPhase::IDLE)
+    , m_selfTestSampleCount(0)
+    , m_selfTestRecalStart(0)
 {
     for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
         m_sensors[i].active = false;
@@ -21,11 +59,42 @@ TouchController::TouchController()
         m_sensors[i].debouncedTouched = false;
         m_sensors[i].lastReportedTouched = false;
         m_sensors[i].lastChangeTime = 0;
+        m_sensors[i].pressStartTime = 0;
+        m_sensors[i].pressStartMicros = 0;
+        m_sensors[i].peakDelta = 0;
+        m_sensors[i].crosstalkSuppressed = false;
+        m_sensors[i].injectedTouched = false;
+        m_sensors[i].syntheticEdge = false;
+        m_sensors[i].lastDelta = 0;
+        m_sensors[i].deltaFresh = false;
+        m_adjacency[i] = 0;
+        m_sensitivity[i] = SENSITIVITY_UNCHANGED;
+        m_addresses[i] = SENSOR_I2C_ADDRESSES[i];
         
         m_expectDown[i].active = false;
         m_expectDown[i].commandId = COMMAND_ID_NONE;
+        m_expectDown[i].profile = DebounceProfile::NORMAL;
         m_expectUp[i].active = false;
         m_expectUp[i].commandId = COMMAND_ID_NONE;
+        m_expectUp[i].profile = DebounceProfile::NORMAL;
+        
+        memset(&m_selfTestResults[i], 0, sizeof(SelfTestResult));
+        m_selfTestResults[i].recalTimeMs = -1;
+    }
+    
+    memset(m_discovered, 0, sizeof(m_discovered));
+    memset(&m_script, 0, sizeof(m_script));
+    memset(&m_scriptRequest, 0, sizeof(m_scriptRequest));
+    memset(&m_stats, 0, sizeof(m_stats));
+    memset(m_scenes, 0, sizeof(m_scenes));
+    
+    for (const auto& pair : SENSOR_ADJACENT_PAIRS) {
+        uint8_t a = letterToIndex(pair[0]);
+        uint8_t b = letterToIndex(pair[1]);
+        if (a < TOUCH_SENSOR_COUNT && b < TOUCH_SENSOR_COUNT && a != b) {
+            m_adjacency[a] |= (1UL << b);
+            m_adjacency[b] |= (1UL << a);
+        }
     }
 }
 
@@ -38,6 +107,11 @@ void TouchController::setEventQueue(EventQueue* eventQueue) {
 }
 
 bool TouchController::begin() {
+    // A chip left mid-transfer by a reset would hide every sensor from discovery.
+    // On a retry the driver still holds the pins, so stop it first (as in recoverBus()).
+    Wire.end();
+    releaseBus();
+    
     // ESP32: Initialize I2C with specific pins
     Wire.begin(PIN_I2C_SDA, PIN_I2C_SCL);
     Wire.setClock(I2C_CLOCK_SPEED_HZ);
@@ -45,23 +119,42 @@ bool TouchController::begin() {
     
     m_activeSensorCount = 0;
     
+    loadAddressMap();
+    
+    // Full-bus pass: every CAP1188 found is configured, mapped or not
+    discoverSensors();
+    
+    // Only positions whose chip was actually found get polled
     for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
-        uint8_t address = SENSOR_I2C_ADDRESSES[i];
-        
-        if (initSensor(address)) {
-            m_sensors[i].active = true;
+        m_sensors[i].active = m_addresses[i] != 0 && isDiscovered(m_addresses[i]);
+        if (m_sensors[i].active) {
             m_activeSensorCount++;
-        } else {
-            m_sensors[i].active = false;
         }
-        
-        m_sensors[i].currentTouched = false;
-        m_sensors[i].debouncedTouched = false;
-        m_sensors[i].lastReportedTouched = false;
-        m_sensors[i].lastChangeTime = 0;
-        
-        delay(10);
+        resetSensorState(i);
+    }
+    
+    m_busRequest = BusRequestType::NONE;
+    
+    if (!m_injectQueue) {
+        m_injectQueue = xQueueCreate(INJECT_QUEUE_SIZE, sizeof(InjectedEdge));
     }
+    m_pendingInjectionCount = 0;
+    m_failedSweeps = 0;
+    m_lastRecoveryTime = 0;
+    
+    if (!m_sensorRequestQueue) {
+        m_sensorRequestQueue = xQueueCreate(TOUCH_REQUEST_QUEUE_SIZE, sizeof(SensorRequest));
+    }
+    if (!m_sensorResultQueue) {
+        m_sensorResultQueue = xQueueCreate(TOUCH_REQUEST_QUEUE_SIZE, sizeof(SensorResult));
+    }
+    if (!m_edgeQueue) {
+        m_edgeQueue = xQueueCreate(TOUCH_EDGE_QUEUE_SIZE, sizeof(TouchEdge));
+    }
+    
+    m_powerMode = SensorPowerMode::ACTIVE;
+    m_wakeRequested = false;
+    m_lastActivityTime = millis();
     
     return m_activeSensorCount > 0;
 }
@@ -69,20 +162,52 @@ bool TouchController::begin() {
 void TouchController::tick() {
     uint32_t now = millis();
     
-    if (now - m_lastPollTime < TOUCH_POLL_INTERVAL_MS) {
+    // Expectation armed while sleeping: wake immediately, don't wait for the sweep
+    if (m_wakeRequested) {
+        m_wakeRequested = false;
+        m_lastActivityTime = now;
+        if (m_powerMode != SensorPowerMode::ACTIVE) {
+            setPowerMode(SensorPowerMode::ACTIVE, m_wakeRequestMicros);
+        }
+    }
+    
+    if (m_busRequest != BusRequestType::NONE) {
+        processBusRequest(now);
+    }
+    processSensorRequests();
+    
+    // Deep sleep stops sensing entirely, nothing to poll
+    if (m_powerMode == SensorPowerMode::DEEP_SLEEP) {
+        return;
+    }
+    
+    uint16_t interval = (m_powerMode == SensorPowerMode::ACTIVE) ? TOUCH_POLL_INTERVAL_MS
+                                                                 : TOUCH_STANDBY_POLL_INTERVAL_MS;
+    if (now - m_lastPollTime < interval) {
         return;
     }
     m_lastPollTime = now;
     
-    pollSensors();
+    checkBusHealth(pollSensors(), now);
+    if (TOUCH_CROSSTALK_SUPPRESSION) {
+        suppressCrosstalk();
+    }
+    runInjectScript(now);
+    processInjections(now);
+    checkReaction();
     processDebounce();
+    updatePowerPolicy(now);
+    
+    if (m_selfTestPhase != SelfTestPhase::IDLE && m_selfTestPhase != SelfTestPhase::COMPLETE) {
+        runSelfTest(now);
+    }
 }
 
 bool TouchController::recalibrate(uint8_t sensorIndex) {
     if (sensorIndex >= TOUCH_SENSOR_COUNT) return false;
     if (!m_sensors[sensorIndex].active) return false;
     
-    uint8_t address = SENSOR_I2C_ADDRESSES[sensorIndex];
+    uint8_t address = m_addresses[sensorIndex];
     return writeRegister(address, CAP1188_REG_CALIBRATION_ACTIVE, CAP1188_CS1_BIT_MASK);
 }
 
@@ -99,7 +224,7 @@ bool TouchController::setSensitivity(uint8_t sensorIndex, uint8_t level) {
     if (!m_sensors[sensorIndex].active) return false;
     if (level > 7) return false;
     
-    uint8_t address = SENSOR_I2C_ADDRESSES[sensorIndex];
+    uint8_t address = m_addresses[sensorIndex];
     
     // Read current sensitivity register value
     uint8_t regValue;
@@ -111,19 +236,27 @@ bool TouchController::setSensitivity(uint8_t sensorIndex, uint8_t level) {
     // 0 = 128x (most sensitive), 7 = 1x (least sensitive)
     regValue = (regValue & 0x8F) | (level << 4);
     
-    return writeRegister(address, CAP1188_REG_SENSITIVITY_CONTROL, regValue);
+    if (!writeRegister(address, CAP1188_REG_SENSITIVITY_CONTROL, regValue)) {
+        return false;
+    }
+    m_sensitivity[sensorIndex] = level;
+    return true;
 }
 
-void TouchController::setExpectDown(uint8_t sensorIndex, uint32_t commandId) {
+void TouchController::setExpectDown(uint8_t sensorIndex, uint32_t commandId, DebounceProfile profile) {
     if (sensorIndex >= TOUCH_SENSOR_COUNT) return;
-    m_expectDown[sensorIndex].active = true;
+    m_expectDown[sensorIndex].profile = profile;
     m_expectDown[sensorIndex].commandId = commandId;
+    m_expectDown[sensorIndex].active = true;
+    requestWake();
 }
 
-void TouchController::setExpectUp(uint8_t sensorIndex, uint32_t commandId) {
+void TouchController::setExpectUp(uint8_t sensorIndex, uint32_t commandId, DebounceProfile profile) {
     if (sensorIndex >= TOUCH_SENSOR_COUNT) return;
-    m_expectUp[sensorIndex].active = true;
+    m_expectUp[sensorIndex].profile = profile;
     m_expectUp[sensorIndex].commandId = commandId;
+    m_expectUp[sensorIndex].active = true;
+    requestWake();
 }
 
 void TouchController::clearExpectDown(uint8_t sensorIndex) {
@@ -138,6 +271,121 @@ void TouchController::clearExpectUp(uint8_t sensorIndex) {
     m_expectUp[sensorIndex].commandId = COMMAND_ID_NONE;
 }
 
+void TouchController::storeExpectations(uint8_t slot) {
+    if (slot >= SCENE_SLOTS) return;
+    
+    TouchScene& scene = m_scenes[slot];
+    scene.expectDown = 0;
+    scene.expectUp = 0;
+    
+    for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+        if (m_expectDown[i].active) scene.expectDown |= 1UL << i;
+        if (m_expectUp[i].active) scene.expectUp |= 1UL << i;
+        scene.downProfiles[i] = m_expectDown[i].profile;
+        scene.upProfiles[i] = m_expectUp[i].profile;
+    }
+}
+
+/**
+ * @brief Re-arms exactly the stored expectations, all under one command ID
+ */
+void TouchController::recallExpectations(uint8_t slot, uint32_t commandId) {
+    if (slot >= SCENE_SLOTS) return;
+    
+    const TouchScene& scene = m_scenes[slot];
+    for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+        if (!(scene.expectDown & (1UL << i))) clearExpectDown(i);
+        if (!(scene.expectUp & (1UL << i))) clearExpectUp(i);
+    }
+    
+    for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+        if (scene.expectDown & (1UL << i)) setExpectDown(i, commandId, scene.downProfiles[i]);
+        if (scene.expectUp & (1UL << i)) setExpectUp(i, commandId, scene.upProfiles[i]);
+    }
+}
+
+/**
+ * @brief Starts or stops handing debounced presses to takeTouchEdge()
+ * 
+ * Starting drops presses left over from an earlier listener. While set,
+ * the sensors stay active as if an expectation were armed.
+ */
+void TouchController::setEdgeListener(bool enabled) {
+    if (enabled && m_edgeQueue) {
+        xQueueReset(m_edgeQueue);
+    }
+    m_edgeListener = enabled;
+    if (enabled) requestWake();
+}
+
+bool TouchController::takeTouchEdge(TouchEdge& edge) {
+    return m_edgeQueue && xQueueReceive(m_edgeQueue, &edge, 0) == pdTRUE;
+}
+
+/**
+ * @brief Arms the reaction probe on a sensor and keeps the sensors awake
+ * 
+ * Nothing is measured until startReaction() gives the start instant.
+ */
+void TouchController::armReaction(uint8_t sensorIndex) {
+    if (sensorIndex >= TOUCH_SENSOR_COUNT) return;
+    portENTER_CRITICAL(&m_reactMux);
+    m_reactStarted = false;
+    m_reactDone = false;
+    m_reactSensor = sensorIndex;
+    m_reactArmed = true;
+    portEXIT_CRITICAL(&m_reactMux);
+    requestWake();
+}
+
+void TouchController::startReaction(uint32_t startMicros) {
+    portENTER_CRITICAL(&m_reactMux);
+    m_reactStartMicros = startMicros;
+    m_reactStarted = true;
+    portEXIT_CRITICAL(&m_reactMux);
+}
+
+void TouchController::disarmReaction() {
+    portENTER_CRITICAL(&m_reactMux);
+    m_reactArmed = false;
+    portEXIT_CRITICAL(&m_reactMux);
+}
+
+bool TouchController::takeReaction(uint32_t& reactionUs) {
+    portENTER_CRITICAL(&m_reactMux);
+    bool done = m_reactDone;
+    if (done) {
+        reactionUs = m_reactUs;
+        m_reactDone = false;
+    }
+    portEXIT_CRITICAL(&m_reactMux);
+    return done;
+}
+
+/**
+ * @brief Completes the reaction probe on the first raw press after the start
+ * 
+ * Runs on the touch task after each sweep. The press edge is taken from
+ * the sweep that saw it, before debounce, so the result is accurate to one
+ * poll interval. A press that began before the start never counts; the pad
+ * has to be released and pressed again.
+ */
+void TouchController::checkReaction() {
+    if (!m_reactArmed || !m_reactStarted) return;
+    
+    portENTER_CRITICAL(&m_reactMux);
+    if (m_reactArmed && m_reactStarted) {
+        const TouchSensorState& sensor = m_sensors[m_reactSensor];
+        int32_t reaction = (int32_t)(sensor.pressStartMicros - m_reactStartMicros);
+        if (sensor.currentTouched && reaction >= 0) {
+            m_reactUs = reaction;
+            m_reactArmed = false;
+            m_reactDone = true;
+        }
+    }
+    portEXIT_CRITICAL(&m_reactMux);
+}
+
 void TouchController::buildActiveSensorList(char* buffer, size_t bufferSize) const {
     if (bufferSize == 0) return;
     
@@ -172,19 +420,217 @@ uint8_t TouchController::getActiveSensorCount() const {
     return m_activeSensorCount;
 }
 
+/**
+ * @brief Current delta of a sensor, from the latest sweep if it read one
+ */
 bool TouchController::readSensorValue(uint8_t sensorIndex, int8_t& value) {
     if (sensorIndex >= TOUCH_SENSOR_COUNT) return false;
     if (!m_sensors[sensorIndex].active) return false;
     
-    uint8_t address = SENSOR_I2C_ADDRESSES[sensorIndex];
-    uint8_t rawValue;
+    if (m_sensors[sensorIndex].deltaFresh) {
+        value = m_sensors[sensorIndex].lastDelta;
+        return true;
+    }
+    return readDelta(m_addresses[sensorIndex], value);
+}
+
+bool TouchController::requestValue(uint8_t sensorIndex, uint32_t commandId) {
+    return submitSensorRequest(SensorRequestType::VALUE, sensorIndex, 0, commandId);
+}
+
+bool TouchController::requestRecalibrate(uint8_t sensorIndex, uint32_t commandId) {
+    return submitSensorRequest(SensorRequestType::RECALIBRATE, sensorIndex, 0, commandId);
+}
+
+bool TouchController::requestRecalibrateAll(uint32_t commandId) {
+    return submitSensorRequest(SensorRequestType::RECALIBRATE_ALL, 0, 0, commandId);
+}
+
+bool TouchController::requestSensitivity(uint8_t sensorIndex, uint8_t level, uint32_t commandId) {
+    return submitSensorRequest(SensorRequestType::SET_SENSITIVITY, sensorIndex, level, commandId);
+}
+
+/**
+ * @brief Level-triggered EXPECT / EXPECT_RELEASE
+ * 
+ * Armed and checked against the debounced state on the touch task, the
+ * same task that reports edges, so no edge can fall between the two.
+ */
+bool TouchController::requestExpectLevel(uint8_t sensorIndex, bool down, uint32_t commandId,
+                                         DebounceProfile profile) {
+    return submitSensorRequest(down ? SensorRequestType::EXPECT_DOWN_LEVEL : SensorRequestType::EXPECT_UP_LEVEL,
+                               sensorIndex, (uint8_t)profile, commandId);
+}
+
+/**
+ * @brief Result of the last submitted VALUE / RECALIBRATE / SET_SENSITIVITY
+ * 
+ * Results of earlier requests (whose caller already gave up) are dropped.
+ */
+bool TouchController::takeSensorResult(SensorResult& result) {
+    while (m_sensorResultQueue && xQueueReceive(m_sensorResultQueue, &result, 0) == pdTRUE) {
+        if (result.sequence == m_requestSequence) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Withdraws the last submitted request if the touch task has not taken it up
+ * @return false if it already started; its result will still arrive
+ */
+bool TouchController::cancelSensorRequest() {
+    bool cancelled = false;
+    portENTER_CRITICAL(&m_requestMux);
+    if (m_startedSequence != m_requestSequence) {
+        m_cancelledSequence = m_requestSequence;
+        cancelled = true;
+    }
+    portEXIT_CRITICAL(&m_requestMux);
+    return cancelled;
+}
+
+/**
+ * @brief Hands a sensor request to the touch task (false = queue full)
+ * 
+ * The touch task owns the bus: it applies requests between sweeps. VALUE,
+ * RECALIBRATE and SET_SENSITIVITY come back through takeSensorResult() so
+ * Core 1 sends their reply in command order.
+ */
+bool TouchController::submitSensorRequest(SensorRequestType type, uint8_t sensorIndex, uint8_t level,
+                                          uint32_t commandId) {
+    if (!m_sensorRequestQueue) return false;
     
-    // Read delta count for CS1 (only CS1 is enabled per sensor)
-    if (!readRegister(address, CAP1188_REG_SENSOR_INPUT_DELTA_1, rawValue)) {
+    SensorRequest request;
+    request.type = type;
+    request.sensorIndex = sensorIndex;
+    request.level = level;
+    request.sequence = (uint8_t)(m_requestSequence + 1);
+    if (request.sequence == 0) request.sequence = 1;
+    request.commandId = commandId;
+    if (xQueueSend(m_sensorRequestQueue, &request, 0) != pdTRUE) {
         return false;
     }
+    m_requestSequence = request.sequence;
+    return true;
+}
+
+bool TouchController::injectTouch(uint8_t sensorIndex, bool down, uint16_t delayMs) {
+    if (sensorIndex >= TOUCH_SENSOR_COUNT) return false;
+    if (!m_sensors[sensorIndex].active || !m_injectQueue) return false;
     
-    value = static_cast<int8_t>(rawValue);  // Interpret as signed
+    InjectedEdge edge;
+    edge.sensorIndex = sensorIndex;
+    edge.down = down;
+    edge.dueTime = millis() + delayMs;
+    
+    if (xQueueSend(m_injectQueue, &edge, 0) != pdTRUE) return false;
+    
+    requestWake();
+    return true;
+}
+
+bool TouchController::startInjectScript(InjectPattern pattern, uint16_t rateHz, uint16_t count,
+                                        uint16_t holdMs) {
+    if (rateHz == 0 || rateHz > INJECT_MAX_RATE_HZ || count == 0) return false;
+    if (m_scriptRequested || m_scriptActive) return false;
+    
+    m_scriptRequest.pattern = pattern;
+    m_scriptRequest.periodMs = 1000 / rateHz;
+    m_scriptRequest.holdMs = holdMs;
+    m_scriptRequest.remaining = count;
+    m_scriptRequest.nextTime = millis();
+    m_scriptRequest.cursor = 0;
+    
+    m_scriptStopRequested = false;
+    m_scriptOverflowed = false;
+    m_scriptRequested = true;
+    requestWake();
+    return true;
+}
+
+void TouchController::stopInjectScript() {
+    m_scriptStopRequested = true;
+}
+
+bool TouchController::isInjectScriptComplete() const {
+    return !m_scriptRequested && !m_scriptActive;
+}
+
+bool TouchController::didInjectScriptOverflow() const {
+    return m_scriptOverflowed;
+}
+
+TouchStats TouchController::getStats() const {
+    return m_stats;
+}
+
+bool TouchController::requestDiscover(uint32_t commandId) {
+    if (m_busRequest != BusRequestType::NONE) return false;
+    
+    m_busRequestCommandId = commandId;
+    m_busRequest = BusRequestType::DISCOVER;
+    return true;
+}
+
+bool TouchController::requestAssign(uint8_t address, uint8_t sensorIndex, uint32_t commandId) {
+    if (sensorIndex >= TOUCH_SENSOR_COUNT) return false;
+    if (m_busRequest != BusRequestType::NONE) return false;
+    
+    m_busRequestAddress = address;
+    m_busRequestSensor = sensorIndex;
+    m_busRequestCommandId = commandId;
+    m_busRequest = BusRequestType::ASSIGN;
+    return true;
+}
+
+bool TouchController::requestAssignByTouch(uint8_t sensorIndex, uint32_t commandId) {
+    if (sensorIndex >= TOUCH_SENSOR_COUNT) return false;
+    if (m_busRequest != BusRequestType::NONE) return false;
+    
+    m_busRequestSensor = sensorIndex;
+    m_busRequestCommandId = commandId;
+    m_busRequestTime = millis();
+    m_assignPollTime = m_busRequestTime - TOUCH_ASSIGN_POLL_INTERVAL_MS;
+    // Unknown counts as held: a pad already pressed must be let go and pressed again
+    memset(m_assignHeld, 0xFF, sizeof(m_assignHeld));
+    m_busRequest = BusRequestType::ASSIGN_TOUCH;
+    requestWake();
+    return true;
+}
+
+uint8_t TouchController::getSensorAddress(uint8_t sensorIndex) const {
+    if (sensorIndex >= TOUCH_SENSOR_COUNT) return 0;
+    return m_addresses[sensorIndex];
+}
+
+SensorPowerMode TouchController::getPowerMode() const {
+    return m_powerMode;
+}
+
+uint32_t TouchController::getLastWakeLatencyUs() const {
+    return m_lastWakeLatencyUs;
+}
+
+void TouchController::startSelfTest() {
+    // A run already in progress simply keeps going
+    if (m_selfTestPhase == SelfTestPhase::IDLE || m_selfTestPhase == SelfTestPhase::COMPLETE) {
+        m_selfTestPhase = SelfTestPhase::STARTING;
+        requestWake();
+    }
+}
+
+bool TouchController::isSelfTestComplete() const {
+    return m_selfTestPhase == SelfTestPhase::COMPLETE;
+}
+
+bool TouchController::getSelfTestResult(uint8_t sensorIndex, SelfTestResult& result) const {
+    if (sensorIndex >= TOUCH_SENSOR_COUNT) return false;
+    if (!m_sensors[sensorIndex].active) return false;
+    if (m_selfTestPhase != SelfTestPhase::COMPLETE) return false;
+    
+    result = m_selfTestResults[sensorIndex];
     return true;
 }
 
@@ -203,6 +649,17 @@ char TouchController::indexToLetter(uint8_t index) {
     return '?';
 }
 
+uint16_t TouchController::debounceWindowMs(DebounceProfile profile, bool press) {
+    switch (profile) {
+        case DebounceProfile::FAST:
+            return press ? TOUCH_DEBOUNCE_FAST_PRESS_MS : TOUCH_DEBOUNCE_FAST_RELEASE_MS;
+        case DebounceProfile::STRICT:
+            return press ? TOUCH_DEBOUNCE_STRICT_PRESS_MS : TOUCH_DEBOUNCE_STRICT_RELEASE_MS;
+        default:
+            return press ? TOUCH_DEBOUNCE_PRESS_MS : TOUCH_DEBOUNCE_RELEASE_MS;
+    }
+}
+
 // ============================================================================
 // Private Methods
 // ============================================================================
@@ -214,7 +671,7 @@ bool TouchController::initSensor(uint8_t address) {
     delay(10);
     
     uint8_t prodId;
-    if (!readRegister(address, CAP1188_REG_PRODUCT_ID, prodId) || prodId != 0x50) {
+    if (!readRegister(address, CAP1188_REG_PRODUCT_ID, prodId) || prodId != CAP1188_PRODUCT_ID) {
         return false;
     }
     
@@ -222,7 +679,10 @@ bool TouchController::initSensor(uint8_t address) {
     if (!writeRegister(address, CAP1188_REG_MULTIPLE_TOUCH_CONFIG, 0x00)) return false;
     
     // Speed up cycle time
-    if (!writeRegister(address, CAP1188_REG_STANDBY_CONFIG, 0x30)) return false;
+    if (!writeRegister(address, CAP1188_REG_STANDBY_CONFIG, CAP1188_STANDBY_CONFIG_FAST)) return false;
+    
+    // CS1 is the only input sampled in standby
+    if (!writeRegister(address, CAP1188_REG_STANDBY_CHANNEL, CAP1188_CS1_BIT_MASK)) return false;
     
     // Enable only CS1 input
     if (!writeRegister(address, CAP1188_REG_SENSOR_INPUT_ENABLE, CAP1188_CS1_BIT_MASK)) return false;
@@ -249,6 +709,18 @@ bool TouchController::writeRegister(uint8_t address, uint8_t reg, uint8_t value)
     return Wire.endTransmission() == 0;
 }
 
+bool TouchController::readDelta(uint8_t address, int8_t& value) {
+    uint8_t rawValue;
+    
+    // Read delta count for CS1 (only CS1 is enabled per sensor)
+    if (!readRegister(address, CAP1188_REG_SENSOR_INPUT_DELTA_1, rawValue)) {
+        return false;
+    }
+    
+    value = static_cast<int8_t>(rawValue);  // Interpret as signed
+    return true;
+}
+
 int8_t TouchController::readRawTouch(uint8_t address) {
     uint8_t status;
     
@@ -268,21 +740,355 @@ int8_t TouchController::readRawTouch(uint8_t address) {
     return touched ? 1 : 0;
 }
 
-void TouchController::pollSensors() {
+/**
+ * @brief Reads every active sensor once
+ * 
+ * A sensor whose read fails keeps its previous state for this sweep.
+ * Returns false if sensors are active but none of them answered. With no
+ * active sensor (e.g. the bus was stuck at boot) the lines are checked
+ * instead, so a stuck bus still reaches recovery.
+ */
+bool TouchController::pollSensors() {
     uint32_t now = millis();
+    bool anyPolled = false;
+    bool anyAnswered = false;
     
     for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
         if (!m_sensors[i].active) continue;
         
-        uint8_t address = SENSOR_I2C_ADDRESSES[i];
-        bool touched = readRawTouch(address);
+        m_sensors[i].deltaFresh = false;
+        uint8_t address = m_addresses[i];
+        int8_t raw = readRawTouch(address);
+        anyPolled = true;
+        if (raw < 0) continue;
+        anyAnswered = true;
+        
+        bool touched = raw == 1;
+        if (m_sensors[i].injectedTouched) {
+            touched = true;
+        }
+        
+        // A suppressed ghost stays ignored until the pad reads released
+        if (m_sensors[i].crosstalkSuppressed) {
+            if (!touched) {
+                m_sensors[i].crosstalkSuppressed = false;
+            }
+            continue;
+        }
         
         if (touched != m_sensors[i].currentTouched) {
             m_sensors[i].currentTouched = touched;
+            m_sensors[i].syntheticEdge = false;
             // Only reset debounce timer if the new state differs from debounced state
             // This prevents noise from resetting the timer while holding a touch
             if (touched != m_sensors[i].debouncedTouched) {
                 m_sensors[i].lastChangeTime = now;
+                
+                // A new press starts fresh metrics
+                if (touched) {
+                    m_sensors[i].pressStartTime = now;
+                    m_sensors[i].pressStartMicros = micros();
+                    m_sensors[i].peakDelta = 0;
+                }
+            }
+        }
+        
+        // Track press intensity while the pad is held (also used for cross-talk arbitration)
+        if ((TOUCH_REPORT_METRICS || TOUCH_CROSSTALK_SUPPRESSION) && touched) {
+            int8_t delta;
+            if (readDelta(address, delta)) {
+                m_sensors[i].lastDelta = delta;
+                m_sensors[i].deltaFresh = true;
+                if (delta > m_sensors[i].peakDelta) {
+                    m_sensors[i].peakDelta = delta;
+                }
+            }
+        }
+    }
+    
+    if (!anyPolled) {
+        return busLinesIdle();
+    }
+    return anyAnswered;
+}
+
+/**
+ * @brief Line-level bus check: between transfers both lines idle high
+ * 
+ * A low SDA or SCL means a chip (or a short) is holding the bus.
+ */
+bool TouchController::busLinesIdle() const {
+    return digitalRead(PIN_I2C_SDA) == HIGH && digitalRead(PIN_I2C_SCL) == HIGH;
+}
+
+/**
+ * @brief Starts bus recovery after I2C_BUS_FAIL_SWEEPS silent sweeps in a row
+ * 
+ * Single failing chips are not a bus problem and are left alone. While the
+ * bus stays down, recovery is retried every I2C_RECOVERY_RETRY_MS.
+ */
+void TouchController::checkBusHealth(bool responded, uint32_t now) {
+    if (responded) {
+        m_failedSweeps = 0;
+        m_lastRecoveryTime = 0;
+        return;
+    }
+    
+    if (m_failedSweeps == 0) {
+        m_busFailTime = now;
+    }
+    if (m_failedSweeps < I2C_BUS_FAIL_SWEEPS) {
+        m_failedSweeps++;
+        return;
+    }
+    if (m_lastRecoveryTime != 0 && now - m_lastRecoveryTime < I2C_RECOVERY_RETRY_MS) {
+        return;
+    }
+    m_lastRecoveryTime = now;
+    
+    uint8_t configured = recoverBus();
+    if (configured == 0) return;
+    
+    if (m_eventQueue) {
+        m_eventQueue->queueBusRecovered(millis() - m_busFailTime, configured);
+    }
+    m_failedSweeps = 0;
+    m_lastRecoveryTime = 0;
+}
+
+/**
+ * @brief Frees SDA from a chip stuck mid-transfer, then sends a STOP
+ * 
+ * The chip lets go once it has clocked out the rest of its byte, so SCL is
+ * pulsed (at most I2C_RECOVERY_CLOCK_PULSES times) until SDA reads high.
+ * Leaves both lines released for Wire. Returns true if SDA ended up high.
+ */
+bool TouchController::releaseBus() {
+    pinMode(PIN_I2C_SDA, INPUT_PULLUP);
+    pinMode(PIN_I2C_SCL, OUTPUT_OPEN_DRAIN);
+    digitalWrite(PIN_I2C_SCL, HIGH);
+    delayMicroseconds(I2C_RECOVERY_HALF_PERIOD_US);
+    
+    for (uint8_t i = 0; i < I2C_RECOVERY_CLOCK_PULSES && digitalRead(PIN_I2C_SDA) == LOW; i++) {
+        digitalWrite(PIN_I2C_SCL, LOW);
+        delayMicroseconds(I2C_RECOVERY_HALF_PERIOD_US);
+        digitalWrite(PIN_I2C_SCL, HIGH);
+        delayMicroseconds(I2C_RECOVERY_HALF_PERIOD_US);
+    }
+    
+    // STOP: SDA rises while SCL is high
+    digitalWrite(PIN_I2C_SCL, LOW);
+    pinMode(PIN_I2C_SDA, OUTPUT_OPEN_DRAIN);
+    digitalWrite(PIN_I2C_SDA, LOW);
+    delayMicroseconds(I2C_RECOVERY_HALF_PERIOD_US);
+    digitalWrite(PIN_I2C_SCL, HIGH);
+    delayMicroseconds(I2C_RECOVERY_HALF_PERIOD_US);
+    digitalWrite(PIN_I2C_SDA, HIGH);
+    delayMicroseconds(I2C_RECOVERY_HALF_PERIOD_US);
+    
+    pinMode(PIN_I2C_SDA, INPUT_PULLUP);
+    pinMode(PIN_I2C_SCL, INPUT_PULLUP);
+    return digitalRead(PIN_I2C_SDA) == HIGH;
+}
+
+/**
+ * @brief Restarts the bus and reconfigures every active sensor
+ * 
+ * Chips that browned out come back with power-on defaults, so each one is
+ * set up again as in begin(), gets its SET_SENSITIVITY level back and is
+ * put back into the current power mode. If no sensor is active, the bus
+ * was down from boot on, so discovery runs again first.
+ * Returns the number of sensors configured (0 = bus still down).
+ */
+uint8_t TouchController::recoverBus() {
+    Wire.end();
+    releaseBus();
+    Wire.begin(PIN_I2C_SDA, PIN_I2C_SCL);
+    Wire.setClock(I2C_CLOCK_SPEED_HZ);
+    
+    if (m_activeSensorCount == 0) {
+        discoverSensors();
+        refreshActiveSensors();
+    }
+    
+    uint8_t configured = 0;
+    for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+        if (!m_sensors[i].active || !initSensor(m_addresses[i])) continue;
+        
+        if (m_sensitivity[i] != SENSITIVITY_UNCHANGED) {
+            setSensitivity(i, m_sensitivity[i]);
+        }
+        configured++;
+    }
+    
+    if (configured > 0 && m_powerMode != SensorPowerMode::ACTIVE) {
+        setPowerMode(m_powerMode, micros());
+    }
+    return configured;
+}
+
+/**
+ * @brief Same-sweep arbitration between adjacent sensors
+ * 
+ * A pending press (raw touched, not yet debounced) loses to any touched
+ * neighbor whose press started within TOUCH_CROSSTALK_WINDOW_MS and shows
+ * a larger peak delta. Ties go to the lower index. The loser never reaches
+ * debounce, so no event is generated for it. Injected presses are exact by
+ * definition and never take part, on either side of a pair.
+ */
+void TouchController::suppressCrosstalk() {
+    for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+        TouchSensorState& sensor = m_sensors[i];
+        if (!sensor.active || !sensor.currentTouched || sensor.debouncedTouched) continue;
+        if (sensor.injectedTouched) continue;
+        
+        for (uint8_t j = 0; j < TOUCH_SENSOR_COUNT; j++) {
+            if (!(m_adjacency[i] & (1UL << j))) continue;
+            
+            const TouchSensorState& neighbor = m_sensors[j];
+            if (!neighbor.active || !neighbor.currentTouched || neighbor.injectedTouched) continue;
+            
+            uint32_t startGap = (sensor.pressStartTime > neighbor.pressStartTime)
+                                    ? sensor.pressStartTime - neighbor.pressStartTime
+                                    : neighbor.pressStartTime - sensor.pressStartTime;
+            if (startGap > TOUCH_CROSSTALK_WINDOW_MS) continue;
+            
+            if (sensor.peakDelta < neighbor.peakDelta ||
+                (sensor.peakDelta == neighbor.peakDelta && i > j)) {
+                sensor.currentTouched = false;
+                sensor.crosstalkSuppressed = true;
+                m_stats.suppressed++;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Generates edges for a running INJECT_RUN script
+ * 
+ * Each step presses the chosen sensor(s) now and schedules the release
+ * holdMs later. The script completes once its last release has been applied.
+ * A step's press and release slots are reserved together: a step that does
+ * not fit is not pressed at all and ends the run (didInjectScriptOverflow()),
+ * so no press is ever left without its release.
+ */
+void TouchController::runInjectScript(uint32_t now) {
+    if (m_scriptRequested) {
+        m_script = m_scriptRequest;
+        m_scriptActive = true;
+        m_scriptRequested = false;
+    }
+    
+    if (!m_scriptActive) return;
+    
+    if (m_scriptStopRequested) {
+        m_script.remaining = 0;
+        m_scriptStopRequested = false;
+    }
+    
+    if (m_script.remaining == 0) {
+        if (m_pendingInjectionCount == 0) {
+            m_scriptActive = false;
+        }
+        return;
+    }
+    
+    if ((int32_t)(now - m_script.nextTime) < 0) return;
+    
+    m_script.nextTime += m_script.periodMs;
+    m_script.remaining--;
+    
+    if (m_activeSensorCount == 0) return;
+    
+    uint8_t stepEdges = (m_script.pattern == InjectPattern::ALL) ? m_activeSensorCount * 2 : 2;
+    if (!hasPendingInjectionRoom(stepEdges)) {
+        m_scriptOverflowed = true;
+        m_script.remaining = 0;
+        return;
+    }
+    
+    switch (m_script.pattern) {
+        case InjectPattern::SEQUENCE:
+        case InjectPattern::RANDOM: {
+            uint8_t skip = (m_script.pattern == InjectPattern::RANDOM) ? random(m_activeSensorCount) : 0;
+            
+            for (uint8_t n = 0; n < TOUCH_SENSOR_COUNT; n++) {
+                uint8_t i = (m_script.cursor + n) % TOUCH_SENSOR_COUNT;
+                if (!m_sensors[i].active) continue;
+                if (skip > 0) { skip--; continue; }
+                
+                schedulePendingInjection(i, true, now);
+                schedulePendingInjection(i, false, now + m_script.holdMs);
+                m_script.cursor = i + 1;
+                break;
+            }
+            break;
+        }
+            
+        case InjectPattern::ALL:
+            for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+                if (!m_sensors[i].active) continue;
+                schedulePendingInjection(i, true, now);
+                schedulePendingInjection(i, false, now + m_script.holdMs);
+            }
+            break;
+    }
+}
+
+bool TouchController::hasPendingInjectionRoom(uint8_t edges) const {
+    return INJECT_PENDING_SIZE - m_pendingInjectionCount >= edges;
+}
+
+/**
+ * @brief Adds an edge to m_pendingInjections (room checked by the caller)
+ */
+void TouchController::schedulePendingInjection(uint8_t sensorIndex, bool down, uint32_t dueTime) {
+    InjectedEdge& edge = m_pendingInjections[m_pendingInjectionCount++];
+    edge.sensorIndex = sensorIndex;
+    edge.down = down;
+    edge.dueTime = dueTime;
+}
+
+/**
+ * @brief Applies injected edges that are due, just before debounce
+ * 
+ * Edges from INJECT stay in m_injectQueue while m_pendingInjections is full,
+ * so a full pipeline shows up as BUSY on Core 1 instead of a lost edge.
+ */
+void TouchController::processInjections(uint32_t now) {
+    InjectedEdge edge;
+    while (m_injectQueue && hasPendingInjectionRoom(1) && xQueueReceive(m_injectQueue, &edge, 0) == pdTRUE) {
+        schedulePendingInjection(edge.sensorIndex, edge.down, edge.dueTime);
+    }
+    
+    uint8_t i = 0;
+    while (i < m_pendingInjectionCount) {
+        if ((int32_t)(now - m_pendingInjections[i].dueTime) >= 0) {
+            applyInjectedEdge(m_pendingInjections[i].sensorIndex, m_pendingInjections[i].down, now);
+            m_pendingInjections[i] = m_pendingInjections[--m_pendingInjectionCount];
+        } else {
+            i++;
+        }
+    }
+}
+
+void TouchController::applyInjectedEdge(uint8_t sensorIndex, bool down, uint32_t now) {
+    TouchSensorState& sensor = m_sensors[sensorIndex];
+    if (!sensor.active) return;
+    
+    sensor.injectedTouched = down;
+    
+    // Same bookkeeping pollSensors() does for a raw edge
+    if (down != sensor.currentTouched && !sensor.crosstalkSuppressed) {
+        sensor.currentTouched = down;
+        sensor.syntheticEdge = true;
+        if (down != sensor.debouncedTouched) {
+            sensor.lastChangeTime = now;
+            if (down) {
+                sensor.pressStartTime = now;
+                sensor.pressStartMicros = micros();
+                sensor.peakDelta = 0;
             }
         }
     }
@@ -300,8 +1106,9 @@ void TouchController::processDebounce() {
         if (sensor.currentTouched != sensor.debouncedTouched) {
             uint32_t elapsed = now - sensor.lastChangeTime;
             
-            // Use different debounce times: shorter for touch, longer for release
-            uint16_t requiredDebounce = sensor.currentTouched ? TOUCH_DEBOUNCE_PRESS_MS : TOUCH_DEBOUNCE_RELEASE_MS;
+            // Press/release windows come from the profile of the armed expectation
+            uint16_t requiredDebounce = debounceWindowMs(edgeProfile(i, sensor.currentTouched),
+                                                         sensor.currentTouched);
             
             if (elapsed >= requiredDebounce) {
                 sensor.debouncedTouched = sensor.currentTouched;
@@ -309,25 +1116,521 @@ void TouchController::processDebounce() {
                 if (sensor.debouncedTouched != sensor.lastReportedTouched) {
                     sensor.lastReportedTouched = sensor.debouncedTouched;
                     
-                    if (m_eventQueue) {
-                        char letter = indexToLetter(i);
-                        
-                        if (sensor.debouncedTouched) {
-                            if (m_expectDown[i].active) {
-                                m_eventQueue->queueTouched(letter, m_expectDown[i].commandId);
-                                m_expectDown[i].active = false;
-                                m_expectDown[i].commandId = COMMAND_ID_NONE;
-                            }
-                        } else {
-                            if (m_expectUp[i].active) {
-                                m_eventQueue->queueTouchReleased(letter, m_expectUp[i].commandId);
-                                m_expectUp[i].active = false;
-                                m_expectUp[i].commandId = COMMAND_ID_NONE;
-                            }
-                        }
+                    if (sensor.debouncedTouched) m_stats.touched++; else m_stats.released++;
+                    if (sensor.syntheticEdge) {
+                        m_stats.synthetic++;
+                        sensor.syntheticEdge = false;
+                    }
+                    
+                    if (sensor.debouncedTouched && m_edgeListener && m_edgeQueue) {
+                        TouchEdge edge = { i, sensor.pressStartTime };
+                        xQueueSend(m_edgeQueue, &edge, 0);
+                    }
+                    
+                    if (sensor.debouncedTouched) {
+                        if (m_expectDown[i].active) reportExpectDown(i, false);
+                    } else {
+                        if (m_expectUp[i].active) reportExpectUp(i, false);
                     }
                 }
             }
         }
     }
 }
+
+/**
+ * @brief Sends TOUCHED for the armed press expectation and disarms it
+ * 
+ * A LEVEL expectation met by a press already held when it was armed has
+ * no press of its own to measure, so it is reported without metrics.
+ */
+void TouchController::reportExpectDown(uint8_t sensorIndex, bool levelSatisfied) {
+    TouchSensorState& sensor = m_sensors[sensorIndex];
+    char letter = indexToLetter(sensorIndex);
+    
+    if (m_eventQueue) {
+        if (TOUCH_REPORT_METRICS && !levelSatisfied) {
+            m_eventQueue->queueTouched(letter, m_expectDown[sensorIndex].commandId, sensor.peakDelta);
+        } else {
+            m_eventQueue->queueTouched(letter, m_expectDown[sensorIndex].commandId);
+        }
+    }
+    m_expectDown[sensorIndex].active = false;
+    m_expectDown[sensorIndex].commandId = COMMAND_ID_NONE;
+}
+
+/**
+ * @brief Sends TOUCH_RELEASED for the armed release expectation and disarms it
+ * 
+ * Without metrics when a LEVEL expectation finds the sensor already released.
+ */
+void TouchController::reportExpectUp(uint8_t sensorIndex, bool levelSatisfied) {
+    TouchSensorState& sensor = m_sensors[sensorIndex];
+    char letter = indexToLetter(sensorIndex);
+    
+    if (m_eventQueue) {
+        if (TOUCH_REPORT_METRICS && !levelSatisfied) {
+            // lastChangeTime holds the raw release edge
+            uint32_t duration = sensor.lastChangeTime - sensor.pressStartTime;
+            m_eventQueue->queueTouchReleased(letter, m_expectUp[sensorIndex].commandId,
+                                             sensor.peakDelta, duration);
+        } else {
+            m_eventQueue->queueTouchReleased(letter, m_expectUp[sensorIndex].commandId);
+        }
+    }
+    m_expectUp[sensorIndex].active = false;
+    m_expectUp[sensorIndex].commandId = COMMAND_ID_NONE;
+}
+
+/**
+ * @brief Debounce profile for the next press or release edge of a sensor
+ * 
+ * Each edge follows the expectation that waits for it: EXPECT for presses,
+ * EXPECT_RELEASE for releases. With only the other one armed, its profile
+ * covers both edges; with none armed the edge is debounced as NORMAL.
+ */
+DebounceProfile TouchController::edgeProfile(uint8_t sensorIndex, bool press) const {
+    const ExpectState& own = press ? m_expectDown[sensorIndex] : m_expectUp[sensorIndex];
+    const ExpectState& other = press ? m_expectUp[sensorIndex] : m_expectDown[sensorIndex];
+    
+    if (own.active) return own.profile;
+    if (other.active) return other.profile;
+    return DebounceProfile::NORMAL;
+}
+
+/**
+ * @brief Advances the self-test state machine by one sweep
+ * 
+ * SAMPLING reads the delta register of every active sensor once per sweep,
+ * timing each transaction. RECALIBRATING triggers a calibration on all
+ * sensors at once and polls CALIBRATION_ACTIVE until each one clears.
+ */
+void TouchController::runSelfTest(uint32_t now) {
+    switch (m_selfTestPhase) {
+        case SelfTestPhase::STARTING:
+            for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+                memset(&m_selfTestResults[i], 0, sizeof(SelfTestResult));
+                m_selfTestResults[i].recalTimeMs = -1;
+            }
+            m_selfTestSampleCount = 0;
+            m_selfTestPhase = SelfTestPhase::SAMPLING;
+            break;
+            
+        case SelfTestPhase::SAMPLING:
+            for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+                if (!m_sensors[i].active) continue;
+                
+                SelfTestResult& result = m_selfTestResults[i];
+                int8_t delta;
+                
+                uint32_t start = micros();
+                bool ok = readDelta(m_addresses[i], delta);
+                uint32_t elapsed = micros() - start;
+                
+                result.i2cTotalUs += elapsed;
+                if (elapsed > result.i2cMaxUs) {
+                    result.i2cMaxUs = (elapsed > 0xFFFF) ? 0xFFFF : elapsed;
+                }
+                
+                if (ok) {
+                    result.samples++;
+                    result.deltaSum += delta;
+                    result.deltaSumSq += (int32_t)delta * delta;
+                } else {
+                    result.errors++;
+                }
+            }
+            
+            if (++m_selfTestSampleCount >= SELFTEST_SAMPLE_COUNT) {
+                for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+                    if (m_sensors[i].active) {
+                        writeRegister(m_addresses[i], CAP1188_REG_CALIBRATION_ACTIVE,
+                                      CAP1188_CS1_BIT_MASK);
+                    }
+                }
+                m_selfTestRecalStart = now;
+                m_selfTestPhase = SelfTestPhase::RECALIBRATING;
+            }
+            break;
+            
+        case SelfTestPhase::RECALIBRATING: {
+            bool pending = false;
+            
+            for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+                if (!m_sensors[i].active) continue;
+                if (m_selfTestResults[i].recalTimeMs >= 0) continue;
+                
+                uint8_t calActive;
+                if (readRegister(m_addresses[i], CAP1188_REG_CALIBRATION_ACTIVE, calActive) &&
+                    (calActive & CAP1188_CS1_BIT_MASK) == 0) {
+                    m_selfTestResults[i].recalTimeMs = now - m_selfTestRecalStart;
+                } else {
+                    pending = true;
+                }
+            }
+            
+            // Sensors still calibrating at the timeout keep recalTimeMs = -1
+            if (!pending || now - m_selfTestRecalStart >= SELFTEST_RECAL_TIMEOUT_MS) {
+                m_selfTestPhase = SelfTestPhase::COMPLETE;
+            }
+            break;
+        }
+            
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Called from Core 1 when an expectation is armed
+ * 
+ * Always raised (even when active) so a concurrent drop to standby on the
+ * touch task is undone on its next tick.
+ */
+void TouchController::requestWake() {
+    m_wakeRequestMicros = micros();
+    m_wakeRequested = true;
+}
+
+/**
+ * @brief Moves sensors between active, standby and deep sleep
+ * 
+ * Any armed expectation, running self-test, press listener (SEQ_VERIFY)
+ * or held touch counts as activity.
+ * A touch seen while in standby wakes the board (the touch itself is still
+ * debounced and reported normally).
+ */
+void TouchController::updatePowerPolicy(uint32_t now) {
+    bool busy = (m_selfTestPhase != SelfTestPhase::IDLE && m_selfTestPhase != SelfTestPhase::COMPLETE) ||
+                m_busRequest != BusRequestType::NONE ||
+                m_scriptActive || m_pendingInjectionCount > 0 || m_edgeListener || m_reactArmed;
+    
+    for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT && !busy; i++) {
+        if (m_expectDown[i].active || m_expectUp[i].active ||
+            (m_sensors[i].active && (m_sensors[i].currentTouched || m_sensors[i].debouncedTouched))) {
+            busy = true;
+        }
+    }
+    
+    if (busy) {
+        m_lastActivityTime = now;
+        if (m_powerMode != SensorPowerMode::ACTIVE) {
+            setPowerMode(SensorPowerMode::ACTIVE, micros());
+        }
+        return;
+    }
+    
+    uint32_t idle = now - m_lastActivityTime;
+    
+    if (TOUCH_DEEP_SLEEP_AFTER_MS > 0 && idle >= TOUCH_DEEP_SLEEP_AFTER_MS) {
+        if (m_powerMode != SensorPowerMode::DEEP_SLEEP) {
+            setPowerMode(SensorPowerMode::DEEP_SLEEP, 0);
+        }
+    } else if (TOUCH_STANDBY_AFTER_MS > 0 && idle >= TOUCH_STANDBY_AFTER_MS) {
+        if (m_powerMode == SensorPowerMode::ACTIVE) {
+            setPowerMode(SensorPowerMode::STANDBY, 0);
+        }
+    }
+}
+
+void TouchController::setPowerMode(SensorPowerMode mode, uint32_t wakeStartMicros) {
+    uint8_t powerBits = 0;
+    if (mode == SensorPowerMode::STANDBY) powerBits = CAP1188_MAIN_STBY_BIT;
+    if (mode == SensorPowerMode::DEEP_SLEEP) powerBits = CAP1188_MAIN_DSLEEP_BIT;
+    
+    uint8_t standbyConfig = (mode == SensorPowerMode::ACTIVE) ? CAP1188_STANDBY_CONFIG_FAST
+                                                              : CAP1188_STANDBY_CONFIG_LOW_POWER;
+    
+    for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+        if (!m_sensors[i].active) continue;
+        
+        uint8_t address = m_addresses[i];
+        writeRegister(address, CAP1188_REG_STANDBY_CONFIG, standbyConfig);
+        
+        uint8_t mainControl;
+        if (readRegister(address, CAP1188_REG_MAIN_CONTROL, mainControl)) {
+            mainControl = (mainControl & ~(CAP1188_MAIN_STBY_BIT | CAP1188_MAIN_DSLEEP_BIT)) | powerBits;
+            writeRegister(address, CAP1188_REG_MAIN_CONTROL, mainControl);
+        }
+    }
+    
+    m_powerMode = mode;
+    
+    if (!m_eventQueue) return;
+    
+    if (mode == SensorPowerMode::ACTIVE) {
+        m_lastWakeLatencyUs = micros() - wakeStartMicros;
+        m_eventQueue->queuePower("ACTIVE", m_lastWakeLatencyUs);
+    } else {
+        m_eventQueue->queuePower(mode == SensorPowerMode::STANDBY ? "STANDBY" : "DEEP_SLEEP");
+    }
+}
+
+// ============================================================================
+// Discovery & Address Map
+// ============================================================================
+
+void TouchController::loadAddressMap() {
+    Preferences prefs;
+    if (!prefs.begin(TOUCH_MAP_NVS_NAMESPACE, true)) return;
+    
+    uint8_t stored[TOUCH_SENSOR_COUNT];
+    if (prefs.getBytesLength(TOUCH_MAP_NVS_KEY) == sizeof(stored) &&
+        prefs.getBytes(TOUCH_MAP_NVS_KEY, stored, sizeof(stored)) == sizeof(stored)) {
+        memcpy(m_addresses, stored, sizeof(m_addresses));
+    }
+    prefs.end();
+}
+
+void TouchController::saveAddressMap() {
+    Preferences prefs;
+    if (!prefs.begin(TOUCH_MAP_NVS_NAMESPACE, false)) return;
+    
+    prefs.putBytes(TOUCH_MAP_NVS_KEY, m_addresses, sizeof(m_addresses));
+    prefs.end();
+}
+
+/**
+ * @brief Probes the whole bus for CAP1188 chips by product ID
+ * 
+ * Every chip found is configured via initSensor(), so unassigned chips can
+ * take part in touch-to-assign.
+ */
+void TouchController::discoverSensors() {
+    memset(m_discovered, 0, sizeof(m_discovered));
+    m_discoveredCount = 0;
+    
+    for (uint8_t address = I2C_DISCOVERY_FIRST_ADDRESS; address <= I2C_DISCOVERY_LAST_ADDRESS; address++) {
+        if (initSensor(address)) {
+            m_discovered[address >> 5] |= (1UL << (address & 0x1F));
+            m_discoveredCount++;
+        }
+    }
+}
+
+bool TouchController::isDiscovered(uint8_t address) const {
+    if (address >= 128) return false;
+    return (m_discovered[address >> 5] & (1UL << (address & 0x1F))) != 0;
+}
+
+int8_t TouchController::findSensorByAddress(uint8_t address) const {
+    for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+        if (m_addresses[i] == address) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Maps an address to a position (0 clears it) and persists the map
+ * 
+ * An address can only belong to one position; a previous owner is cleared.
+ */
+void TouchController::assignAddress(uint8_t address, uint8_t sensorIndex) {
+    if (address != 0) {
+        int8_t previous = findSensorByAddress(address);
+        if (previous >= 0 && previous != sensorIndex) {
+            m_addresses[previous] = 0;
+            m_sensors[previous].active = false;
+            resetSensorState(previous);
+        }
+    }
+    
+    m_addresses[sensorIndex] = address;
+    m_sensors[sensorIndex].active = address != 0 && isDiscovered(address);
+    resetSensorState(sensorIndex);
+    
+    m_activeSensorCount = 0;
+    for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+        if (m_sensors[i].active) m_activeSensorCount++;
+    }
+    
+    saveAddressMap();
+}
+
+void TouchController::resetSensorState(uint8_t sensorIndex) {
+    TouchSensorState& sensor = m_sensors[sensorIndex];
+    sensor.currentTouched = false;
+    sensor.debouncedTouched = false;
+    sensor.lastReportedTouched = false;
+    sensor.lastChangeTime = 0;
+    sensor.pressStartTime = 0;
+    sensor.pressStartMicros = 0;
+    sensor.peakDelta = 0;
+    sensor.crosstalkSuppressed = false;
+    sensor.injectedTouched = false;
+    sensor.syntheticEdge = false;
+}
+
+/**
+ * @brief Activates mapped chips found by the last discovery, deactivates missing ones
+ */
+void TouchController::refreshActiveSensors() {
+    for (uint8_t i = 0; i < TOUCH_SENSOR_COUNT; i++) {
+        bool present = m_addresses[i] != 0 && isDiscovered(m_addresses[i]);
+        if (present != m_sensors[i].active) {
+            m_sensors[i].active = present;
+            resetSensorState(i);
+            if (present) m_activeSensorCount++; else m_activeSensorCount--;
+        }
+    }
+}
+
+void TouchController::processBusRequest(uint32_t now) {
+    uint32_t cmdId = m_busRequestCommandId;
+    char letter = indexToLetter(m_busRequestSensor);
+    
+    switch (m_busRequest) {
+        case BusRequestType::DISCOVER: {
+            discoverSensors();
+            refreshActiveSensors();
+            
+            if (m_eventQueue) {
+                char list[DISCOVERED_LIST_CHUNK_LENGTH];
+                uint8_t next = I2C_DISCOVERY_FIRST_ADDRESS;
+                do {
+                    next = buildUnassignedList(list, sizeof(list), next);
+                    m_eventQueue->queueDiscovered(m_discoveredCount, list, next != 0, cmdId);
+                } while (next != 0);
+            }
+            break;
+        }
+            
+        case BusRequestType::ASSIGN:
+            if (m_busRequestAddress != 0 && !isDiscovered(m_busRequestAddress)) {
+                if (m_eventQueue) m_eventQueue->queueError("sensor_not_found", cmdId);
+                break;
+            }
+            assignAddress(m_busRequestAddress, m_busRequestSensor);
+            if (m_eventQueue) m_eventQueue->queueAssigned(letter, m_busRequestAddress, cmdId);
+            break;
+            
+        case BusRequestType::ASSIGN_TOUCH:
+            // Wait for a new press on any discovered chip that has no position yet
+            if (now - m_assignPollTime >= TOUCH_ASSIGN_POLL_INTERVAL_MS) {
+                m_assignPollTime = now;
+                
+                for (uint8_t address = I2C_DISCOVERY_FIRST_ADDRESS; address <= I2C_DISCOVERY_LAST_ADDRESS; address++) {
+                    if (!isDiscovered(address) || findSensorByAddress(address) >= 0) continue;
+                    
+                    int8_t touched = readRawTouch(address);
+                    if (touched < 0) continue;  // Read failed: keep the last state
+                    
+                    uint32_t bit = 1UL << (address & 0x1F);
+                    bool wasHeld = (m_assignHeld[address >> 5] & bit) != 0;
+                    if (touched == 1) {
+                        m_assignHeld[address >> 5] |= bit;
+                    } else {
+                        m_assignHeld[address >> 5] &= ~bit;
+                    }
+                    
+                    if (touched == 1 && !wasHeld) {
+                        assignAddress(address, m_busRequestSensor);
+                        if (m_eventQueue) m_eventQueue->queueAssigned(letter, address, cmdId);
+                        m_busRequest = BusRequestType::NONE;
+                        return;
+                    }
+                }
+            }
+            
+            if (now - m_busRequestTime >= TOUCH_ASSIGN_TIMEOUT_MS) {
+                if (m_eventQueue) m_eventQueue->queueError("assign_timeout", cmdId);
+                break;
+            }
+            return;  // Keep waiting
+            
+        default:
+            break;
+    }
+    
+    m_busRequest = BusRequestType::NONE;
+}
+
+void TouchController::processSensorRequests() {
+    SensorRequest request;
+    
+    while (m_sensorRequestQueue && xQueueReceive(m_sensorRequestQueue, &request, 0) == pdTRUE) {
+        // Core 1 answered ERR sensor_timeout for a cancelled request: drop it unapplied
+        bool cancelled;
+        portENTER_CRITICAL(&m_requestMux);
+        cancelled = (request.sequence == m_cancelledSequence);
+        if (cancelled) {
+            m_cancelledSequence = 0;
+        } else {
+            m_startedSequence = request.sequence;
+        }
+        portEXIT_CRITICAL(&m_requestMux);
+        if (cancelled) continue;
+        
+        uint32_t cmdId = request.commandId;
+        
+        SensorResult result;
+        result.type = request.type;
+        result.sensorIndex = request.sensorIndex;
+        result.sequence = request.sequence;
+        result.ok = true;
+        result.value = 0;
+        result.commandId = cmdId;
+        
+        switch (request.type) {
+            case SensorRequestType::VALUE:
+                result.ok = readSensorValue(request.sensorIndex, result.value);
+                break;
+                
+            case SensorRequestType::RECALIBRATE:
+                result.ok = recalibrate(request.sensorIndex);
+                break;
+                
+            case SensorRequestType::RECALIBRATE_ALL:
+                recalibrateAll();
+                break;
+                
+            case SensorRequestType::SET_SENSITIVITY:
+                result.ok = setSensitivity(request.sensorIndex, request.level);
+                break;
+                
+            // Debounced state is settled here: edges are only reported later in this tick.
+            // The ACK goes out from here, once armed, so it always precedes the report.
+            case SensorRequestType::EXPECT_DOWN_LEVEL:
+                setExpectDown(request.sensorIndex, cmdId, static_cast<DebounceProfile>(request.level));
+                if (m_eventQueue) m_eventQueue->queueAck("EXPECT", indexToLetter(request.sensorIndex), cmdId);
+                if (m_sensors[request.sensorIndex].active && m_sensors[request.sensorIndex].debouncedTouched) {
+                    reportExpectDown(request.sensorIndex, true);
+                }
+                break;
+                
+            case SensorRequestType::EXPECT_UP_LEVEL:
+                setExpectUp(request.sensorIndex, cmdId, static_cast<DebounceProfile>(request.level));
+                if (m_eventQueue) m_eventQueue->queueAck("EXPECT_RELEASE", indexToLetter(request.sensorIndex), cmdId);
+                if (m_sensors[request.sensorIndex].active && !m_sensors[request.sensorIndex].debouncedTouched) {
+                    reportExpectUp(request.sensorIndex, true);
+                }
+                break;
+        }
+        
+        if (m_sensorResultQueue) {
+            xQueueSend(m_sensorResultQueue, &result, 0);
+        }
+    }
+}
+
+/**
+ * @brief Lists unassigned discovered addresses from firstAddress on
+ * 
+ * @return The first address that did not fit, 0 once the list is complete
+ */
+uint8_t TouchController::buildUnassignedList(char* buffer, size_t bufferSize, uint8_t firstAddress) const {
+    if (bufferSize == 0) return 0;
+    
+    buffer[0] = '\0';
+    size_t pos = 0;
+    
+    for (uint8_t address = firstAddress; address <= I2C_DISCOVERY_LAST_ADDRESS; address++) {
+        if (!isDiscovered(address) || findSensorByAddress(address) >= 0) continue;
+        
+        size_t needed = (pos == 0) ? 3 : 4;
+        if (pos + needed > bufferSize) return address;  // Continues on the next line
+        
+        pos += snprintf(buffer + pos, bufferSize - pos, (pos == 0) ? "%02X" : ",%02X", address);
+    }
+    return 0;
+}
@@ -10,7 +10,8 @@
  * 
  * Architecture:
  *   - Core 0: Touch sensor polling task (I2C at configurable interval)
- *   - Core 1: Main loop (serial, commands) + LED animation task
+ *             + LED output task (clocks composed frames out to the strips)
+ *   - Core 1: Serial RX task (line parsing) + main loop (commands, LED composition)
  * 
  * Purpose:
  *   Hardware executor for LED and touch control. All game logic resides
@@ -31,6 +32,7 @@
 #include "TouchController.h"
 #include "CommandController.h"
 #include "EventQueue.h"
+#include "LoadGovernor.h"
 
 // ============================================================================
 // Global Instances
@@ -40,9 +42,12 @@ EventQueue eventQueue;
 LedController ledController;
 TouchController touchController;
 CommandController commandController(ledController, &touchController, eventQueue);
+LoadGovernor loadGovernor(ledController, commandController, eventQueue);
 
 // Task handles for monitoring
 TaskHandle_t touchTaskHandle = nullptr;
+TaskHandle_t serialTaskHandle = nullptr;
+TaskHandle_t ledOutputTaskHandle = nullptr;
 
 // ============================================================================
 // FreeRTOS Tasks
@@ -64,6 +69,41 @@ void touchPollingTask(void* parameter) {
     }
 }
 
+/**
+ * @brief Serial receive task (Core 1, above the main loop)
+ * 
+ * Sleeps until the UART driver reports received data (Serial.onReceive runs
+ * from the driver's event queue task), then assembles and parses lines and
+ * hands the commands to loop(). A slow LED frame no longer delays parsing;
+ * the timeout only bounds the wait if a notification is missed.
+ */
+void serialRxTask(void* parameter) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SERIAL_LINE_TIMEOUT_MS));
+        commandController.pollSerial();
+        commandController.parseCompletedLines();
+    }
+}
+
+/**
+ * @brief LED output task (Core 0, below touch polling)
+ * 
+ * Sleeps until loop() hands over a composed frame, then shows it. The strip
+ * transmission (~1.2ms per 40 LEDs) overlaps with loop() composing the next
+ * frame instead of stalling it.
+ */
+void ledOutputTask(void* parameter) {
+    for (;;) {
+        ledController.outputTick();
+    }
+}
+
+void onSerialReceive() {
+    if (serialTaskHandle) {
+        xTaskNotifyGive(serialTaskHandle);
+    }
+}
+
 // ============================================================================
 // Setup
 // ============================================================================
@@ -86,24 +126,12 @@ void setup() {
     
     touchController.setEventQueue(&eventQueue);
     
-    // Initialize touch sensors, retry until all expected sensors are found
-    while (true) {
-        touchController.begin();
-        
-        uint8_t foundCount = touchController.getActiveSensorCount();
-        if (foundCount >= EXPECTED_SENSOR_COUNT) {
-            break;
-        }
-        
-        Serial.print("Found ");
-        Serial.print(foundCount);
-        Serial.print("/");
-        Serial.print(EXPECTED_SENSOR_COUNT);
-        Serial.println(" sensors, retrying...");
-        delay(300);  // Brief delay before retry
-    }
+    // Initialize touch sensors. Missing ones are reported below (SCANNED); a bus
+    // stuck at boot is freed by the touch task's bus recovery, not retried here.
+    touchController.begin();
     
     commandController.begin();
+    loadGovernor.begin();
     
     // Create touch polling task on dedicated core
     xTaskCreatePinnedToCore(
@@ -116,8 +144,30 @@ void setup() {
         CORE_TOUCH_SENSOR
     );
     
-    // Note: LED animation is now handled in main loop to avoid race conditions
-    // with command processing. Both modify the NeoPixel buffer which is not thread-safe.
+    // Serial parsing runs in its own task; execution stays in loop()
+    xTaskCreatePinnedToCore(
+        serialRxTask,
+        "SerialRx",
+        STACK_SIZE_SERIAL_TASK,
+        NULL,
+        PRIORITY_SERIAL_TASK,
+        &serialTaskHandle,
+        CORE_SERIAL_RX
+    );
+    Serial.onReceive(onSerialReceive);
+    
+    // Frames are composed in loop() and shown by the output task; only the
+    // output task touches the NeoPixel buffers once it is running
+    xTaskCreatePinnedToCore(
+        ledOutputTask,
+        "LedOutput",
+        STACK_SIZE_LED_TASK,
+        NULL,
+        PRIORITY_LED_TASK,
+        &ledOutputTaskHandle,
+        CORE_LED_OUTPUT
+    );
+    ledController.setOutputTask(ledOutputTaskHandle);
     
     // Send startup information
     eventQueue.queueInfo(COMMAND_ID_NONE);
@@ -138,19 +188,25 @@ void setup() {
 // ============================================================================
 
 void loop() {
-    // Handle incoming serial commands from Raspberry Pi
-    commandController.pollSerial();
-    commandController.processCompletedLines();
+    uint32_t loopStartUs = micros();
+    
+    // Execute commands parsed by the serial task
+    commandController.executeParsedCommands();
     
     // Advance long-running command execution
     commandController.tick();
     
-    // Update LED animations (done here to avoid race conditions with command processing)
+    // Compose LED animations and hand finished frames to the output task
     ledController.tick();
     
     // Send pending events over serial
     eventQueue.flush(EVENTS_PER_FLUSH);
     
+    // Shed load in steps before events or input get dropped
+    if (LOAD_GOVERNOR_ENABLED) {
+        loadGovernor.tick(micros() - loopStartUs);
+    }
+    
     // Yield to prevent watchdog timeout
     yield();
 }
@@ -0,0 +1,91 @@
+/**
+ * @file Adafruit_NeoPixel.h
+ * @brief Host pixel-buffer strip backend (LED visualizer build only)
+ *
+ * Stores pixels exactly like the real library (GRB order, brightness
+ * applied on write). show() copies them to a "wire" buffer, so the
+ * visualizer sees the bytes the LEDs got with the last show(), not the
+ * firmware's logical framebuffer. Strips register themselves in creation
+ * order (strips()) for the visualizer to find them.
+ */
+
+#ifndef HOST_ADAFRUIT_NEOPIXEL_H
+#define HOST_ADAFRUIT_NEOPIXEL_H
+
+#include <Arduino.h>
+#include <algorithm>
+#include <vector>
+
+typedef uint16_t neoPixelType;
+
+#define NEO_GRB    ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800 0x0000
+
+class Adafruit_NeoPixel {
+public:
+    Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, neoPixelType type = NEO_GRB + NEO_KHZ800)
+        : m_pixels(n * 3, 0), m_wire(n * 3, 0), m_brightness(0), m_showCount(0) {
+        strips().push_back(this);
+    }
+    
+    ~Adafruit_NeoPixel() {
+        strips().erase(std::remove(strips().begin(), strips().end(), this), strips().end());
+    }
+    
+    void begin() {}
+    void show() { m_wire = m_pixels; m_showCount++; }
+    void clear() { std::fill(m_pixels.begin(), m_pixels.end(), 0); }
+    
+    void setBrightness(uint8_t b) { m_brightness = b + 1; }
+    uint8_t getBrightness() const { return m_brightness - 1; }
+    
+    void setPixelColor(uint16_t n, uint32_t c) {
+        if (n >= numPixels()) return;
+        uint8_t r = (uint8_t)(c >> 16), g = (uint8_t)(c >> 8), b = (uint8_t)c;
+        if (m_brightness) {
+            r = (r * m_brightness) >> 8;
+            g = (g * m_brightness) >> 8;
+            b = (b * m_brightness) >> 8;
+        }
+        m_pixels[n * 3] = g;
+        m_pixels[n * 3 + 1] = r;
+        m_pixels[n * 3 + 2] = b;
+    }
+    
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b) {
+        setPixelColor(n, Color(r, g, b));
+    }
+    
+    uint32_t getPixelColor(uint16_t n) const {
+        if (n >= numPixels()) return 0;
+        return ((uint32_t)m_pixels[n * 3 + 1] << 16) | ((uint32_t)m_pixels[n * 3] << 8) | m_pixels[n * 3 + 2];
+    }
+    
+    uint8_t* getPixels() { return m_pixels.data(); }
+    uint16_t numPixels() const { return (uint16_t)(m_pixels.size() / 3); }
+    bool canShow() const { return true; }
+    
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+    
+    // Host side: number of show() calls so far
+    uint32_t showCount() const { return m_showCount; }
+    
+    // Host side: GRB bytes sent by the last show()
+    const std::vector<uint8_t>& wirePixels() const { return m_wire; }
+    
+    // Host side: every strip alive, in creation order
+    static std::vector<Adafruit_NeoPixel*>& strips() {
+        static std::vector<Adafruit_NeoPixel*> all;
+        return all;
+    }
+
+private:
+    std::vector<uint8_t> m_pixels;
+    std::vector<uint8_t> m_wire;
+    uint8_t m_brightness;
+    uint32_t m_showCount;
+};
+
+#endif // HOST_ADAFRUIT_NEOPIXEL_H
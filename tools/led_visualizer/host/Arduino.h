@@ -0,0 +1,82 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the Arduino core (LED visualizer build only)
+ *
+ * Provides just what the firmware sources use. Time comes from a virtual
+ * clock advanced by the visualizer; Serial is an in-memory pipe.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using std::min;
+using std::max;
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void yield();
+long random(long maxValue);
+long random(long minValue, long maxValue);
+
+// GPIO: no pins on the host, inputs read idle high
+#define LOW 0
+#define HIGH 1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define OUTPUT_OPEN_DRAIN 0x13
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+inline void delayMicroseconds(uint32_t) {}
+
+template <class T> T constrain(T value, T low, T high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+// ============================================================================
+// Serial (in-memory: the visualizer writes input and reads output)
+// ============================================================================
+
+class HardwareSerial {
+public:
+    int available();
+    int read();
+    size_t write(const char* buffer, size_t size);
+    size_t write(const uint8_t* buffer, size_t size);
+    size_t write(uint8_t c);
+    size_t print(const char* str);
+    size_t print(long value);
+    size_t println(const char* str = "");
+    void begin(unsigned long) {}
+    void setRxBufferSize(size_t) {}
+    void setTxBufferSize(size_t) {}
+    int availableForWrite() { return 4096; }
+    void flush() {}
+    explicit operator bool() const { return true; }
+    
+    // Host side
+    std::string input;
+    std::string output;
+};
+
+extern HardwareSerial Serial;
+
+// Virtual clock (host side)
+void hostAdvanceMillis(uint32_t ms);
+
+#endif // HOST_ARDUINO_H
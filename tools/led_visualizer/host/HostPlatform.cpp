@@ -0,0 +1,108 @@
+/**
+ * @file HostPlatform.cpp
+ * @brief Definitions behind the host stand-in headers (LED visualizer build only)
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <freertos/queue.h>
+#include <deque>
+#include <vector>
+
+// ============================================================================
+// Virtual Clock
+// ============================================================================
+
+static uint32_t s_nowMillis = 0;
+
+uint32_t millis() { return s_nowMillis; }
+uint32_t micros() { return s_nowMillis * 1000; }
+void delay(uint32_t ms) { s_nowMillis += ms; }
+void yield() {}
+void hostAdvanceMillis(uint32_t ms) { s_nowMillis += ms; }
+
+long random(long maxValue) { return maxValue > 0 ? rand() % maxValue : 0; }
+long random(long minValue, long maxValue) { return minValue + random(maxValue - minValue); }
+
+// ============================================================================
+// Serial
+// ============================================================================
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+int HardwareSerial::available() {
+    return (int)input.size();
+}
+
+int HardwareSerial::read() {
+    if (input.empty()) return -1;
+    int c = (uint8_t)input[0];
+    input.erase(0, 1);
+    return c;
+}
+
+size_t HardwareSerial::write(const char* buffer, size_t size) {
+    output.append(buffer, size);
+    return size;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    return write((const char*)buffer, size);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    output.push_back((char)c);
+    return 1;
+}
+
+size_t HardwareSerial::print(const char* str) {
+    return write(str, strlen(str));
+}
+
+size_t HardwareSerial::print(long value) {
+    return print(std::to_string(value).c_str());
+}
+
+size_t HardwareSerial::println(const char* str) {
+    return print(str) + write((uint8_t)'\n');
+}
+
+// ============================================================================
+// FreeRTOS Queues
+// ============================================================================
+
+struct HostQueue {
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    return new HostQueue{ length, itemSize, {} };
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t) {
+    HostQueue* q = static_cast<HostQueue*>(queue);
+    if (q->items.size() >= q->length) return pdFALSE;
+    const uint8_t* bytes = static_cast<const uint8_t*>(item);
+    q->items.emplace_back(bytes, bytes + q->itemSize);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t) {
+    HostQueue* q = static_cast<HostQueue*>(queue);
+    if (q->items.empty()) return pdFALSE;
+    memcpy(item, q->items.front().data(), q->itemSize);
+    q->items.pop_front();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    return (UBaseType_t)static_cast<HostQueue*>(queue)->items.size();
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    static_cast<HostQueue*>(queue)->items.clear();
+    return pdPASS;
+}
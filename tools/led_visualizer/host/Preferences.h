@@ -0,0 +1,23 @@
+/**
+ * @file Preferences.h
+ * @brief Host NVS stand-in: nothing is stored (LED visualizer build only)
+ */
+
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <Arduino.h>
+
+class Preferences {
+public:
+    bool begin(const char*, bool readOnly = false) { return true; }
+    void end() {}
+    size_t putBytes(const char*, const void*, size_t len) { return len; }
+    size_t getBytes(const char*, void*, size_t) { return 0; }
+    size_t getBytesLength(const char*) { return 0; }
+    bool isKey(const char*) { return false; }
+    bool remove(const char*) { return true; }
+    bool clear() { return true; }
+};
+
+#endif // HOST_PREFERENCES_H
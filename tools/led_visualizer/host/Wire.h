@@ -0,0 +1,27 @@
+/**
+ * @file Wire.h
+ * @brief Host I2C stand-in: an empty bus (LED visualizer build only)
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { return true; }
+    bool end() { return true; }
+    void setClock(uint32_t) {}
+    void setTimeOut(uint16_t) {}
+    void beginTransmission(uint8_t) {}
+    size_t write(uint8_t) { return 1; }
+    uint8_t endTransmission(bool sendStop = true) { return 2; }  // Address NACK: no device
+    uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
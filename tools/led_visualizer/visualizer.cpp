@@ -0,0 +1,302 @@
+/**
+ * @file visualizer.cpp
+ * @brief Host LED visualizer: runs firmware commands and renders frames to images
+ *
+ * Links the real CommandController, LedController and EventQueue against
+ * the stand-ins in host/ (virtual clock, pixel-buffer strips, empty I2C bus)
+ * and drives them the way loop() does, one virtual millisecond per pass.
+ * Frames are captured from the strips' wire buffers after show(), so the
+ * whole output stage (hand-over, indexed expansion, brightness) is covered.
+ *
+ * Usage:
+ *   led_visualizer <script> [-o <dir>] [--frames] [--no-sheet] [--scale <n>]
+ *
+ * Script lines:
+ *   <command>        Sent to the firmware as a serial line (e.g. SUCCESS A)
+ *   @wait <ms>       Run the firmware for ms virtual milliseconds
+ *   @done            Run until no long-running command is in flight
+ *   # ...            Comment
+ *
+ * Output:
+ *   <dir>/sheet.ppm          Contact sheet, one row pair (strip 1, strip 2) per frame
+ *   <dir>/frame_NNNNNN.ppm   One image per frame (--frames)
+ *   stdout                   Serial traffic and frames/duration per command
+ */
+
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+#include <fstream>
+#include <map>
+#include <vector>
+#include "Config.h"
+#include "LedController.h"
+#include "CommandController.h"
+#include "EventQueue.h"
+
+// ============================================================================
+// Firmware Instances (same wiring as main.cpp, without touch)
+// ============================================================================
+
+static EventQueue eventQueue;
+static LedController ledController;
+static CommandController commandController(ledController, nullptr, eventQueue);
+
+// ============================================================================
+// Capture State
+// ============================================================================
+
+struct CapturedFrame {
+    uint32_t number;
+    std::vector<uint8_t> strip1;
+    std::vector<uint8_t> strip2;
+};
+
+struct PendingCommand {
+    std::string line;
+    uint32_t startFrame;
+    uint32_t startTime;
+};
+
+struct Options {
+    std::string scriptPath;
+    std::string outDir = ".";
+    bool writeFrames = false;
+    bool writeSheet = true;
+    int scale = 4;
+};
+
+static std::vector<CapturedFrame> s_frames;
+static std::map<uint32_t, PendingCommand> s_pending;
+static uint32_t s_lastFrame = 0;
+static uint32_t s_nextAutoId = 1000000;
+
+static constexpr uint32_t DONE_TIMEOUT_MS = 60000;
+
+// ============================================================================
+// Firmware Loop
+// ============================================================================
+
+/**
+ * @brief RGB copy of what a strip's last show() put on the wire (GRB)
+ */
+static std::vector<uint8_t> wireToRgb(const Adafruit_NeoPixel& strip) {
+    const std::vector<uint8_t>& grb = strip.wirePixels();
+    std::vector<uint8_t> rgb(grb.size());
+    for (size_t i = 0; i + 2 < grb.size(); i += 3) {
+        rgb[i] = grb[i + 1];
+        rgb[i + 1] = grb[i];
+        rgb[i + 2] = grb[i + 2];
+    }
+    return rgb;
+}
+
+static void captureFrame() {
+    // LedController creates strip 1, then strip 2
+    const std::vector<Adafruit_NeoPixel*>& strips = Adafruit_NeoPixel::strips();
+    
+    CapturedFrame frame;
+    frame.number = ledController.getFrameCount();
+    frame.strip1 = wireToRgb(*strips[0]);
+    frame.strip2 = wireToRgb(*strips[1]);
+    s_frames.push_back(std::move(frame));
+}
+
+static void handleOutputLine(const std::string& line) {
+    printf("< %s\n", line.c_str());
+    
+    size_t hash = line.rfind(" #");
+    bool isDone = line.compare(0, 5, "DONE ") == 0;
+    bool isError = line.compare(0, 4, "ERR ") == 0;
+    if (hash == std::string::npos || (!isDone && !isError)) return;
+    
+    uint32_t id = strtoul(line.c_str() + hash + 2, nullptr, 10);
+    auto it = s_pending.find(id);
+    if (it == s_pending.end()) return;
+    
+    if (isDone) {
+        // Prefer the frame the firmware reports; fall back to the current one
+        uint32_t doneFrame = ledController.getFrameCount();
+        uint32_t doneTime = millis();
+        size_t frameField = line.find(" frame=");
+        size_t timeField = line.find(" t=");
+        if (frameField != std::string::npos && timeField != std::string::npos) {
+            doneFrame = strtoul(line.c_str() + frameField + 7, nullptr, 10);
+            doneTime = strtoul(line.c_str() + timeField + 3, nullptr, 10);
+        }
+        printf("= %-32s frames=%u duration=%ums\n", it->second.line.c_str(),
+               doneFrame - it->second.startFrame, doneTime - it->second.startTime);
+    }
+    s_pending.erase(it);
+}
+
+static void runFirmware(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        commandController.pollSerial();
+        commandController.processCompletedLines();
+        commandController.tick();
+        ledController.tick();
+        eventQueue.flush(EVENTS_PER_FLUSH);
+        
+        if (ledController.getFrameCount() != s_lastFrame) {
+            s_lastFrame = ledController.getFrameCount();
+            captureFrame();
+        }
+        
+        size_t newline;
+        while ((newline = Serial.output.find('\n')) != std::string::npos) {
+            handleOutputLine(Serial.output.substr(0, newline));
+            Serial.output.erase(0, newline + 1);
+        }
+        
+        hostAdvanceMillis(1);
+    }
+}
+
+static void sendCommand(std::string line) {
+    // Tag every command with an id so its DONE can be matched
+    uint32_t id;
+    size_t hash = line.find('#');
+    if (hash == std::string::npos) {
+        id = s_nextAutoId++;
+        line += " #" + std::to_string(id);
+    } else {
+        id = strtoul(line.c_str() + hash + 1, nullptr, 10);
+    }
+    
+    s_pending[id] = { line.substr(0, line.find(" #")), ledController.getFrameCount(), millis() };
+    printf("> %s\n", line.c_str());
+    Serial.input += line + "\n";
+    runFirmware(1);
+}
+
+// ============================================================================
+// Image Output (binary PPM)
+// ============================================================================
+
+static void fillRow(std::vector<uint8_t>& image, int width, int y0, int rows,
+                    const std::vector<uint8_t>& strip, int scale) {
+    for (int y = y0; y < y0 + rows; y++) {
+        for (size_t led = 0; led < strip.size() / 3; led++) {
+            for (int s = 0; s < scale; s++) {
+                uint8_t* px = &image[(y * width + led * scale + s) * 3];
+                memcpy(px, &strip[led * 3], 3);
+            }
+        }
+    }
+}
+
+static bool writePpm(const std::string& path, int width, int height, const std::vector<uint8_t>& rgb) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    out << "P6\n" << width << " " << height << "\n255\n";
+    out.write(reinterpret_cast<const char*>(rgb.data()), rgb.size());
+    return (bool)out;
+}
+
+static int stripImageWidth(int scale) {
+    return (LED_STRIP_1_LENGTH > LED_STRIP_2_LENGTH ? LED_STRIP_1_LENGTH : LED_STRIP_2_LENGTH) * scale;
+}
+
+static bool writeFrameImages(const Options& options) {
+    int width = stripImageWidth(options.scale);
+    int height = options.scale * 3;  // strip 1, gap, strip 2
+    
+    for (const CapturedFrame& frame : s_frames) {
+        std::vector<uint8_t> image(width * height * 3, 0);
+        fillRow(image, width, 0, options.scale, frame.strip1, options.scale);
+        fillRow(image, width, options.scale * 2, options.scale, frame.strip2, options.scale);
+        
+        char name[32];
+        snprintf(name, sizeof(name), "/frame_%06u.ppm", frame.number);
+        if (!writePpm(options.outDir + name, width, height, image)) return false;
+    }
+    return true;
+}
+
+static bool writeContactSheet(const Options& options) {
+    if (s_frames.empty()) return true;
+    
+    const int ledScale = 2;
+    const int rowsPerFrame = ledScale * 2 + 1;  // strip 1, strip 2, separator
+    int width = stripImageWidth(ledScale);
+    int height = (int)s_frames.size() * rowsPerFrame;
+    
+    std::vector<uint8_t> image(width * height * 3, 0);
+    for (size_t i = 0; i < s_frames.size(); i++) {
+        int y = (int)i * rowsPerFrame;
+        fillRow(image, width, y, ledScale, s_frames[i].strip1, ledScale);
+        fillRow(image, width, y + ledScale, ledScale, s_frames[i].strip2, ledScale);
+    }
+    return writePpm(options.outDir + "/sheet.ppm", width, height, image);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+static bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) options.outDir = argv[++i];
+        else if (arg == "--frames") options.writeFrames = true;
+        else if (arg == "--no-sheet") options.writeSheet = false;
+        else if (arg == "--scale" && i + 1 < argc) options.scale = atoi(argv[++i]);
+        else if (options.scriptPath.empty() && arg[0] != '-') options.scriptPath = arg;
+        else return false;
+    }
+    return !options.scriptPath.empty() && options.scale > 0;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(stderr, "usage: %s <script> [-o <dir>] [--frames] [--no-sheet] [--scale <n>]\n", argv[0]);
+        return 2;
+    }
+    
+    std::ifstream script(options.scriptPath);
+    if (!script) {
+        fprintf(stderr, "cannot open %s\n", options.scriptPath.c_str());
+        return 1;
+    }
+    
+    eventQueue.begin();
+    ledController.begin();
+    commandController.begin();
+    s_lastFrame = ledController.getFrameCount();
+    
+    std::string line;
+    while (std::getline(script, line)) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+        line = line.substr(start, line.find_last_not_of(" \t\r") - start + 1);
+        
+        if (line.compare(0, 5, "@wait") == 0) {
+            runFirmware(strtoul(line.c_str() + 5, nullptr, 10));
+        } else if (line == "@done") {
+            uint32_t waited = 0;
+            while (commandController.hasActiveCommands() && waited < DONE_TIMEOUT_MS) {
+                runFirmware(1);
+                waited++;
+            }
+            if (commandController.hasActiveCommands()) {
+                fprintf(stderr, "@done: timed out after %ums\n", DONE_TIMEOUT_MS);
+            }
+        } else {
+            sendCommand(line);
+        }
+    }
+    runFirmware(1);
+    
+    printf("= %zu frames captured\n", s_frames.size());
+    
+    if (options.writeFrames && !writeFrameImages(options)) {
+        fprintf(stderr, "cannot write frames to %s\n", options.outDir.c_str());
+        return 1;
+    }
+    if (options.writeSheet && !writeContactSheet(options)) {
+        fprintf(stderr, "cannot write sheet to %s\n", options.outDir.c_str());
+        return 1;
+    }
+    return 0;
+}